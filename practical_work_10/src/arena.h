@@ -0,0 +1,247 @@
+#ifndef ARENA_H_INCLUDED
+#define ARENA_H_INCLUDED
+
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <openssl/crypto.h>
+#include "definitions.h"
+
+using namespace std;
+
+/**
+ * Request-scoped allocation pool for everything OpenSSL allocates,
+ * including the BIGNUMs behind BigInt and the EC_POINTs behind Point.
+ *
+ * Once installed, OpenSSL allocates through the hooks below. While the
+ * pool is enabled and an Arena::Scope is open on the current thread,
+ * freed blocks are kept in per-thread size-class free lists and handed
+ * out again by the next allocations instead of going back to malloc.
+ * When the outermost scope closes, all the cached blocks are released
+ * in one shot. Blocks that outlive the scope (results, lazily created
+ * library state) stay valid and are freed normally later, so nothing
+ * allocated inside a scope is ever invalidated.
+ *
+ * The pool can be switched on and off at any time for A/B comparisons.
+ */
+class Arena {
+private:
+    static constexpr size_t HEADER_SIZE = 16;
+    static constexpr size_t NUMBER_OF_SIZE_CLASSES = 9;
+    static constexpr size_t MIN_BLOCK_SIZE = 16;
+    static constexpr size_t MAX_BLOCK_SIZE =
+        MIN_BLOCK_SIZE << (NUMBER_OF_SIZE_CLASSES - 1);
+    static constexpr size_t UNPOOLED = NUMBER_OF_SIZE_CLASSES;
+
+    struct Header {
+        size_t sizeClass;
+        size_t size;
+    };
+
+    static_assert(sizeof(Header) <= HEADER_SIZE);
+
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    struct ThreadCache {
+        array<FreeBlock*, NUMBER_OF_SIZE_CLASSES> freeBlocks {};
+        size_t depth = 0;
+
+        void release() {
+            for (FreeBlock*& head : this->freeBlocks) {
+                while (head) {
+                    FreeBlock* next = head->next;
+                    free(reinterpret_cast<Byte*>(head) - HEADER_SIZE);
+                    head = next;
+                }
+            }
+        }
+    };
+
+    /**
+     * Owns the cache of the current thread. The plain pointer is what
+     * the hooks use, it is cleared on thread exit so that late frees
+     * from OpenSSL's own cleanup go straight back to the system.
+     */
+    struct ThreadCacheOwner {
+        ThreadCache cache;
+
+        ThreadCacheOwner() {
+            currentCache = &this->cache;
+        }
+
+        ~ThreadCacheOwner() {
+            currentCache = nullptr;
+            this->cache.release();
+        }
+    };
+
+public:
+    struct Statistics {
+        size_t pooledAllocations;
+        size_t systemAllocations;
+    };
+
+    /**
+     * Marks the lifetime of one request on the current thread.
+     */
+    class Scope {
+    public:
+        Scope() {
+            ThreadCache* cache = getCache();
+            if (cache) {
+                ++cache->depth;
+            }
+        }
+
+        Scope(const Scope& other) = delete;
+
+        ~Scope() {
+            ThreadCache* cache = currentCache;
+            if (cache && cache->depth && !--cache->depth) {
+                cache->release();
+            }
+        }
+
+        Scope& operator=(const Scope& other) = delete;
+    };
+
+private:
+    inline static atomic<bool> installed = false;
+    inline static atomic<bool> enabled = false;
+    inline static atomic<size_t> pooledAllocations = 0;
+    inline static atomic<size_t> systemAllocations = 0;
+    inline static thread_local ThreadCache* currentCache = nullptr;
+
+private:
+    static ThreadCache* getCache() {
+        if (!currentCache) {
+            thread_local ThreadCacheOwner owner;
+        }
+        return currentCache;
+    }
+
+    static size_t getSizeClass(const size_t size) {
+        if (size > MAX_BLOCK_SIZE) {
+            return UNPOOLED;
+        }
+        size_t sizeClass = 0;
+        while ((MIN_BLOCK_SIZE << sizeClass) < size) {
+            ++sizeClass;
+        }
+        return sizeClass;
+    }
+
+    static Header* getHeader(void* block) {
+        return reinterpret_cast<Header*>(
+            reinterpret_cast<Byte*>(block) - HEADER_SIZE
+        );
+    }
+
+    static bool isPooling(const ThreadCache* cache) {
+        return enabled.load(memory_order_relaxed) && cache && cache->depth;
+    }
+
+    static void* allocate(const size_t size, const char*, const int) {
+        ThreadCache* cache = currentCache;
+        const size_t sizeClass = getSizeClass(size);
+        if (sizeClass != UNPOOLED && isPooling(cache)) {
+            FreeBlock*& head = cache->freeBlocks[sizeClass];
+            if (head) {
+                FreeBlock* block = head;
+                head = block->next;
+                getHeader(block)->size = size;
+                pooledAllocations.fetch_add(1, memory_order_relaxed);
+                return block;
+            }
+        }
+
+        const size_t capacity = sizeClass == UNPOOLED
+            ? size : MIN_BLOCK_SIZE << sizeClass;
+        Byte* memory = static_cast<Byte*>(malloc(HEADER_SIZE + capacity));
+        if (!memory) {
+            return nullptr;
+        }
+        systemAllocations.fetch_add(1, memory_order_relaxed);
+        Header* header = reinterpret_cast<Header*>(memory);
+        header->sizeClass = sizeClass;
+        header->size = size;
+        return memory + HEADER_SIZE;
+    }
+
+    static void deallocate(void* block, const char*, const int) {
+        if (!block) {
+            return;
+        }
+        Header* header = getHeader(block);
+        ThreadCache* cache = currentCache;
+        if (header->sizeClass != UNPOOLED && isPooling(cache)) {
+            FreeBlock* freeBlock = static_cast<FreeBlock*>(block);
+            freeBlock->next = cache->freeBlocks[header->sizeClass];
+            cache->freeBlocks[header->sizeClass] = freeBlock;
+            return;
+        }
+        free(header);
+    }
+
+    static void* reallocate(
+        void* block, const size_t size, const char* file, const int line
+    ) {
+        if (!block) {
+            return allocate(size, file, line);
+        }
+        if (!size) {
+            deallocate(block, file, line);
+            return nullptr;
+        }
+        Header* header = getHeader(block);
+        if (
+            header->sizeClass != UNPOOLED
+            && size <= (MIN_BLOCK_SIZE << header->sizeClass)
+        ) {
+            header->size = size;
+            return block;
+        }
+        void* result = allocate(size, file, line);
+        if (result) {
+            memcpy(result, block, min(header->size, size));
+            deallocate(block, file, line);
+        }
+        return result;
+    }
+
+public:
+    /**
+     * Routes OpenSSL allocations through the pool. Has to be called
+     * before OpenSSL allocates anything, otherwise it returns false
+     * and the pool stays unavailable.
+     */
+    static bool install() {
+        if (!installed) {
+            installed = CRYPTO_set_mem_functions(
+                allocate, reallocate, deallocate
+            );
+        }
+        return installed;
+    }
+
+    static bool isInstalled() {
+        return installed;
+    }
+
+    static void setEnabled(const bool value) {
+        enabled = value;
+    }
+
+    static bool isEnabled() {
+        return installed && enabled;
+    }
+
+    static Statistics getStatistics() {
+        return Statistics {pooledAllocations, systemAllocations};
+    }
+};
+
+#endif // ARENA_H_INCLUDED
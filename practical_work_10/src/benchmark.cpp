@@ -0,0 +1,340 @@
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <openssl/bn.h>
+#include <openssl/ec.h>
+#include <openssl/obj_mac.h>
+#include <openssl/objects.h>
+#include "elliptic-cryptography/digital-signature-algorithm.h"
+#include "elliptic-cryptography/schnorr-signature.h"
+
+using namespace std;
+using namespace EllipticCryptography;
+
+const size_t NUMBER_OF_ITERATIONS = 200;
+
+double measure(
+    const function<void()>& operation,
+    size_t numberOfIterations = NUMBER_OF_ITERATIONS
+);
+void report(const string& name, double native, double reference);
+BIGNUM* toBignum(const BigInt& value);
+
+int main() {
+    Arena::install();
+    Arena::setEnabled(true);
+
+    const BuiltinCurve curve = BuiltinCurve::getById(BuiltinCurve::ID::SECP256K1);
+    const BigInt n = curve.getBasePointOrder();
+    const KeyPair keyPair = KeyPair::generate(curve);
+    const PublicKey& Q = keyPair.getPublicKey();
+    const BigInt u1 = BigInt::generateInRange(1, n - 1);
+    const BigInt u2 = BigInt::generateInRange(1, n - 1);
+
+    EC_GROUP* group = EC_GROUP_new_by_curve_name(NID_secp256k1);
+    BN_CTX* ctx = BN_CTX_new();
+    EC_POINT* referenceQ = EC_POINT_new(group);
+    EC_POINT* referenceResult = EC_POINT_new(group);
+    BIGNUM* referenceU1 = toBignum(u1);
+    BIGNUM* referenceU2 = toBignum(u2);
+    BIGNUM* x = toBignum(Q.getCoordinates().x);
+    BIGNUM* y = toBignum(Q.getCoordinates().y);
+    if (
+        !group || !ctx || !referenceQ || !referenceResult
+        || !EC_POINT_set_affine_coordinates(group, referenceQ, x, y, ctx)
+    ) {
+        throw runtime_error(OPERATION_FAILED);
+    }
+
+    cout << "Curve: " << curve << endl;
+    cout << "Microseconds per operation, native vs EC_POINT_mul:" << endl;
+
+    report(
+        "k * G",
+        measure([&] { curve.multiplyBasePoint(u1); }),
+        measure([&] {
+            EC_POINT_mul(group, referenceResult, referenceU1, nullptr, nullptr, ctx);
+        })
+    );
+    report(
+        "k * Q",
+        measure([&] { Q * u2; }),
+        measure([&] {
+            EC_POINT_mul(group, referenceResult, nullptr, referenceQ, referenceU2, ctx);
+        })
+    );
+    report(
+        "u1 * G + u2 * Q",
+        measure([&] { curve.mulAdd(u1, u2, Q); }),
+        measure([&] {
+            EC_POINT_mul(group, referenceResult, referenceU1, referenceQ, referenceU2, ctx);
+        })
+    );
+    cout << endl;
+
+    cout
+        << "Microseconds per u1 * G + u2 * Q on the other builtin curves,"
+            " from a table of Q vs EC_POINT_mul:" << endl;
+    for (const BuiltinCurve::ID id : {
+        BuiltinCurve::ID::P256, BuiltinCurve::ID::P384, BuiltinCurve::ID::P521
+    }) {
+        const BuiltinCurve otherCurve = BuiltinCurve::getById(id);
+        const BigInt& otherN = otherCurve.getBasePointOrder();
+        const PublicKey otherQ = KeyPair::generate(otherCurve).getPublicKey();
+        const FixedBaseMultiplication otherQMultiples(
+            otherQ, otherN, PUBLIC_KEY_CACHE_WINDOW_WIDTH
+        );
+        const BigInt v1 = BigInt::generateInRange(1, otherN - 1);
+        const BigInt v2 = BigInt::generateInRange(1, otherN - 1);
+        EC_GROUP* otherGroup = EC_GROUP_new_by_curve_name(otherCurve.getId());
+        EC_POINT* otherReferenceQ = EC_POINT_new(otherGroup);
+        EC_POINT* otherResult = EC_POINT_new(otherGroup);
+        BIGNUM* referenceV1 = toBignum(v1);
+        BIGNUM* referenceV2 = toBignum(v2);
+        BIGNUM* otherX = toBignum(otherQ.getCoordinates().x);
+        BIGNUM* otherY = toBignum(otherQ.getCoordinates().y);
+        if (
+            !otherGroup || !otherReferenceQ || !otherResult
+            || !EC_POINT_set_affine_coordinates(
+                otherGroup, otherReferenceQ, otherX, otherY, ctx
+            )
+        ) {
+            throw runtime_error(OPERATION_FAILED);
+        }
+        report(
+            OBJ_nid2sn(otherCurve.getId()),
+            measure([&] {
+                otherCurve.getContext()->mulAdd(v1, v2, otherQMultiples);
+            }),
+            measure([&] {
+                EC_POINT_mul(
+                    otherGroup, otherResult, referenceV1, otherReferenceQ, referenceV2, ctx
+                );
+            })
+        );
+        BN_free(otherY);
+        BN_free(otherX);
+        BN_free(referenceV2);
+        BN_free(referenceV1);
+        EC_POINT_free(otherResult);
+        EC_POINT_free(otherReferenceQ);
+        EC_GROUP_free(otherGroup);
+    }
+    report(
+        "Curve lookup",
+        measure([] { BuiltinCurve::getById(BuiltinCurve::ID::P384); }),
+        measure([] {
+            EC_GROUP_free(EC_GROUP_new_by_curve_name(NID_secp384r1));
+        })
+    );
+    cout << endl;
+
+    const DigitalSignatureAlgorithm digitalSignatureAlgorithmInstance(curve);
+    const SchnorrSignature schnorrSignatureInstance(curve);
+    const SignatureAlgorithm& digitalSignatureAlgorithm =
+        digitalSignatureAlgorithmInstance;
+    const SignatureAlgorithm& schnorrSignature = schnorrSignatureInstance;
+    const string message = "Schnorr VS ECDSA";
+    const SignedMessage signedMessage =
+        digitalSignatureAlgorithm.sign(message, keyPair.getPrivateKey());
+    const SignedMessage schnorrSignedMessage =
+        schnorrSignature.sign(message, keyPair.getPrivateKey());
+
+    cout << "Microseconds per operation, arena enabled vs disabled:" << endl;
+    const auto measureWithArena = [](const function<void()>& operation) {
+        Arena::setEnabled(true);
+        const double enabled = measure(operation);
+        Arena::setEnabled(false);
+        const double disabled = measure(operation);
+        Arena::setEnabled(true);
+        report("", enabled, disabled);
+    };
+    cout << "ECDSA sign";
+    measureWithArena([&] {
+        digitalSignatureAlgorithm.sign(message, keyPair.getPrivateKey());
+    });
+    cout << "ECDSA verify";
+    measureWithArena([&] {
+        digitalSignatureAlgorithm.verify(signedMessage, Q);
+    });
+    cout << "EC-Schnorr sign";
+    measureWithArena([&] {
+        schnorrSignature.sign(message, keyPair.getPrivateKey());
+    });
+    cout << "EC-Schnorr verify";
+    measureWithArena([&] {
+        schnorrSignature.verify(schnorrSignedMessage, Q);
+    });
+
+    cout << endl;
+
+    DigitalSignatureAlgorithm cachedDigitalSignatureAlgorithmInstance(curve);
+    SchnorrSignature cachedSchnorrSignatureInstance(curve);
+    const shared_ptr<PublicKeyCache> publicKeyCache = make_shared<PublicKeyCache>();
+    cachedDigitalSignatureAlgorithmInstance.setPublicKeyCache(publicKeyCache);
+    cachedSchnorrSignatureInstance.setPublicKeyCache(publicKeyCache);
+    const SignatureAlgorithm& cachedDigitalSignatureAlgorithm =
+        cachedDigitalSignatureAlgorithmInstance;
+    const SignatureAlgorithm& cachedSchnorrSignature = cachedSchnorrSignatureInstance;
+    cout << "Microseconds per verification of a hot key, cached vs uncached:" << endl;
+    report(
+        "ECDSA verify",
+        measure([&] { cachedDigitalSignatureAlgorithm.verify(signedMessage, Q); }),
+        measure([&] { digitalSignatureAlgorithm.verify(signedMessage, Q); })
+    );
+    report(
+        "EC-Schnorr verify",
+        measure([&] { cachedSchnorrSignature.verify(schnorrSignedMessage, Q); }),
+        measure([&] { schnorrSignature.verify(schnorrSignedMessage, Q); })
+    );
+    report(
+        "Table of a cold key",
+        measure([&] {
+            FixedBaseMultiplication(Q, n, PUBLIC_KEY_CACHE_WINDOW_WIDTH);
+        }, 20),
+        measure([&] { Q * u2; })
+    );
+    cout << endl;
+
+    const size_t batchSize = 1024;
+    vector<OctetString> messages;
+    for (size_t i = 0; i < batchSize; ++i) {
+        const string text = message + " " + to_string(i);
+        messages.push_back(OctetString(text.begin(), text.end()));
+    }
+
+    DigitalSignatureAlgorithm deterministicDigitalSignatureAlgorithmInstance(curve);
+    deterministicDigitalSignatureAlgorithmInstance.setNonceGeneration(
+        NonceGeneration::DETERMINISTIC
+    );
+    const auto signOnThreadPool = [&](const DigitalSignatureAlgorithm& algorithm) {
+        ThreadPool::getShared().forEachShard(
+            batchSize, 1, [&](const size_t begin, const size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    algorithm.sign(messages[i], keyPair.getPrivateKey());
+                }
+            }
+        );
+    };
+    cout
+        << "Microseconds per ECDSA signature on "
+        << ThreadPool::getShared().getNumberOfThreads()
+        << " threads, RFC 6979 vs random nonces:" << endl;
+    report(
+        "Batch of " + to_string(batchSize),
+        measure([&] {
+            signOnThreadPool(deterministicDigitalSignatureAlgorithmInstance);
+        }, 4) / batchSize,
+        measure([&] {
+            signOnThreadPool(digitalSignatureAlgorithmInstance);
+        }, 4) / batchSize
+    );
+    const vector<SignedMessage<OctetString>> signedMessages =
+        digitalSignatureAlgorithmInstance.signBatch(
+            messages, keyPair.getPrivateKey()
+        );
+    const vector<PublicKey> publicKeys(batchSize, Q);
+    cout
+        << "Microseconds per ECDSA verification, verifyBatch on "
+        << ThreadPool::getShared().getNumberOfThreads()
+        << " threads vs verify:" << endl;
+    report(
+        "Batch of " + to_string(batchSize),
+        measure([&] {
+            digitalSignatureAlgorithmInstance.verifyBatch(
+                signedMessages, publicKeys
+            );
+        }, 4) / batchSize,
+        measure([&] {
+            for (const SignedMessage<OctetString>& signedMessage : signedMessages) {
+                digitalSignatureAlgorithmInstance.verify(signedMessage, Q);
+            }
+        }, 4) / batchSize
+    );
+
+    vector<BigInt> scalars;
+    vector<Point> points;
+    for (size_t i = 0; i < batchSize; ++i) {
+        scalars.push_back(BigInt::generateInRange(1, n - 1));
+        points.push_back(curve.multiplyBasePoint(BigInt::generateInRange(1, n - 1)));
+    }
+    cout
+        << "Microseconds per term of a " << batchSize << "-term sum, "
+        "multiScalarMultiply vs linearCombination:" << endl;
+    report(
+        "Sequential",
+        measure([&] { Point::multiScalarMultiply(scalars, points); }, 4) / batchSize,
+        measure([&] { Point::linearCombination(scalars, points); }, 4) / batchSize
+    );
+    report(
+        "Thread pool",
+        measure([&] {
+            Point::multiScalarMultiply(scalars, points, &ThreadPool::getShared());
+        }, 4) / batchSize,
+        measure([&] { Point::linearCombination(scalars, points); }, 4) / batchSize
+    );
+    cout << endl;
+
+    vector<CommittedSignedMessage> committedSignedMessages;
+    for (const OctetString& batchMessage : messages) {
+        committedSignedMessages.push_back(schnorrSignatureInstance.signWithCommitment(
+            batchMessage, keyPair.getPrivateKey()
+        ));
+    }
+    cout
+        << "Microseconds per EC-Schnorr verification, verifyBatch with R "
+        "vs verify:" << endl;
+    report(
+        "Batch of " + to_string(batchSize),
+        measure([&] {
+            schnorrSignatureInstance.verifyBatch(
+                committedSignedMessages, publicKeys
+            );
+        }, 4) / batchSize,
+        measure([&] {
+            for (const CommittedSignedMessage& signedMessage : committedSignedMessages) {
+                schnorrSignatureInstance.verify(signedMessage, Q);
+            }
+        }, 4) / batchSize
+    );
+
+    BN_free(x);
+    BN_free(y);
+    BN_free(referenceU1);
+    BN_free(referenceU2);
+    EC_POINT_free(referenceQ);
+    EC_POINT_free(referenceResult);
+    BN_CTX_free(ctx);
+    EC_GROUP_free(group);
+
+    return 0;
+}
+
+double measure(
+    const function<void()>& operation, const size_t numberOfIterations
+) {
+    operation();
+    const auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < numberOfIterations; ++i) {
+        operation();
+    }
+    const chrono::duration<double, micro> elapsed =
+        chrono::steady_clock::now() - start;
+    return elapsed.count() / numberOfIterations;
+}
+
+void report(const string& name, const double native, const double reference) {
+    cout
+        << name << ": " << fixed << setprecision(1)
+        << native << " vs " << reference
+        << " (x" << setprecision(2) << reference / native << ")" << endl;
+}
+
+BIGNUM* toBignum(const BigInt& value) {
+    BIGNUM* result = nullptr;
+    if (!BN_dec2bn(&result, value.toString().c_str())) {
+        throw runtime_error(OPERATION_FAILED);
+    }
+    return result;
+}
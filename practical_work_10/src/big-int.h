@@ -2,7 +2,13 @@
 #define BIG_INT_H_INCLUDED
 
 #include <ostream>
-#include <functional>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <utility>
 #include <stdexcept>
 #include <bitset>
 #include <openssl/bn.h>
@@ -22,117 +28,334 @@ enum class Radix {
 namespace EllipticCryptography {
     class Curve;
     class BuiltinCurve;
+    class CurveContext;
+    class FixedBaseMultiplication;
     class Point;
 }
 
+namespace EllipticCryptography::Secp256k1 {
+    class Engine;
+}
+
+template<size_t Bits>
+class FixedBigInt;
+
 class BigInt {
 private:
+    template<size_t Bits>
+    friend class FixedBigInt;
     friend class EllipticCryptography::Curve;
     friend class EllipticCryptography::BuiltinCurve;
+    friend class EllipticCryptography::CurveContext;
+    friend class EllipticCryptography::FixedBaseMultiplication;
     friend class EllipticCryptography::Point;
     friend ostream& operator<<(ostream& out, const BigInt& bigInt);
     friend bool areEqual(const EC_GROUP* a, const EC_GROUP* b);
 
-    using BinaryOperation = function<
-        int (BIGNUM*, const BIGNUM*, const BIGNUM*
-    )>;
-    using BinaryOperationWithContext = function<
-        int (BIGNUM*, const BIGNUM*, const BIGNUM*, BN_CTX*)
-    >;
-    using BinaryOperationWithWord = function<int (BIGNUM*, Word)>;
-    using TernaryOperationWithContext = function<
-        int (BIGNUM*, const BIGNUM*, const BIGNUM*, const BIGNUM*, BN_CTX *ctx)
-    >;
-
+public:
+    /**
+     * A lease of a BN_CTX from the pool of the current thread.
+     * Contexts are returned to the pool on destruction and reused by the
+     * next lease, so BN_CTX_new is only called when the pool is empty.
+     * A context can be created once and passed down through several
+     * operations to avoid even the pool round-trip.
+     */
     class Context {
     private:
         friend class BigInt;
+        template<size_t Bits>
+        friend class FixedBigInt;
         friend class EllipticCryptography::Curve;
         friend class EllipticCryptography::BuiltinCurve;
+        friend class EllipticCryptography::CurveContext;
+        friend class EllipticCryptography::FixedBaseMultiplication;
         friend class EllipticCryptography::Point;
+        friend class EllipticCryptography::Secp256k1::Engine;
         friend bool areEqual(const EC_GROUP* a, const EC_GROUP* b);
 
+        struct Pool {
+            vector<BN_CTX*> contexts;
+
+            ~Pool() {
+                for (BN_CTX* ctx : this->contexts) {
+                    BN_CTX_free(ctx);
+                }
+            }
+        };
+
+        /**
+         * Scope of the temporaries taken from a context with BN_CTX_get.
+         */
+        class Frame {
+        private:
+            BN_CTX* ctx;
+
+        public:
+            Frame(const Context& ctx) : ctx(ctx.data) {
+                BN_CTX_start(this->ctx);
+            }
+
+            Frame(const Frame& other) = delete;
+
+            ~Frame() {
+                BN_CTX_end(this->ctx);
+            }
+
+            Frame& operator=(const Frame& other) = delete;
+        };
+
+    private:
+        inline static atomic<size_t> numberOfCreatedContexts = 0;
+
     private:
         BN_CTX* data = nullptr;
 
+    private:
+        static Pool& getPool() {
+            thread_local Pool pool;
+            return pool;
+        }
+
     public:
         Context() {
+            Pool& pool = getPool();
+            if (!pool.contexts.empty()) {
+                this->data = pool.contexts.back();
+                pool.contexts.pop_back();
+                return;
+            }
             this->data = BN_CTX_new();
             if (!this->data) {
                 throw bad_alloc();
             }
+            ++numberOfCreatedContexts;
         }
 
+        Context(const Context& other) = delete;
+
         ~Context() {
-            BN_CTX_free(this->data);
+            try {
+                getPool().contexts.push_back(this->data);
+            } catch (const bad_alloc& e) {
+                BN_CTX_free(this->data);
+            }
+        }
+
+        Context& operator=(const Context& other) = delete;
+
+        static size_t getNumberOfCreatedContexts() {
+            return numberOfCreatedContexts;
         }
     };
 
 private:
+    static constexpr Word MAX_WORD = numeric_limits<Word>::max();
+
+private:
+    /**
+     * A number that fits in a word is kept inline in 'small' and 'data'
+     * stays null until the number takes part in an operation that needs
+     * a BIGNUM, so small values are created, copied and compared without
+     * touching the heap.
+     */
     BIGNUM* data = nullptr;
+    Word small = 0;
 
 private:
-    static BigInt perform(
-        const BinaryOperation& op, const BigInt& a, const BigInt& b
-    ) {
-        BigInt result;
-        if (!op(result.data, a.data, b.data)) {
+    /**
+     * Returns the BIGNUM holding the value, allocating it first if the
+     * number is still stored inline. Used for results of operations.
+     */
+    BIGNUM* output() {
+        if (!this->data) {
+            BIGNUM* data = BN_new();
+            if (!data || !BN_set_word(data, this->small)) {
+                BN_free(data);
+                throw bad_alloc();
+            }
+            this->data = data;
+            this->small = 0;
+        }
+        return this->data;
+    }
+
+    /**
+     * Returns the value as a BIGNUM without modifying the number.
+     * An inline value is copied into a temporary of the given context,
+     * so the caller has to open a Context::Frame around the operation.
+     */
+    const BIGNUM* input(const Context& ctx) const {
+        if (this->data) {
+            return this->data;
+        }
+        BIGNUM* temporary = BN_CTX_get(ctx.data);
+        if (!temporary || !BN_set_word(temporary, this->small)) {
+            throw bad_alloc();
+        }
+        return temporary;
+    }
+
+    bool isSmall() const {
+        return !this->data;
+    }
+
+    int compare(const Word& word) const {
+        if (this->isSmall()) {
+            return this->small < word ? -1 : this->small > word;
+        }
+        if (BN_is_negative(this->data)) {
+            return -1;
+        }
+        if (BN_num_bits(this->data) > BN_BITS2) {
+            return 1;
+        }
+        const Word value = BN_get_word(this->data);
+        return value < word ? -1 : value > word;
+    }
+
+    int compare(const BigInt& other) const {
+        if (other.isSmall()) {
+            return this->compare(other.small);
+        }
+        if (this->isSmall()) {
+            return -other.compare(this->small);
+        }
+        return BN_cmp(this->data, other.data);
+    }
+
+    template<auto operation>
+    static constexpr bool requiresContext = is_invocable_v<
+        decltype(operation), BIGNUM*, const BIGNUM*, const BIGNUM*, BN_CTX*
+    >;
+
+    template<auto operation>
+    static void apply(BIGNUM* result, const BigInt& a, const BigInt& b) {
+        if constexpr (requiresContext<operation>) {
+            apply<operation>(result, a, b, Context());
+        } else if (a.isSmall() || b.isSmall()) {
+            const Context ctx;
+            const Context::Frame frame(ctx);
+            if (!operation(result, a.input(ctx), b.input(ctx))) {
+                throw runtime_error(OPERATION_FAILED);
+            }
+        } else if (!operation(result, a.data, b.data)) {
             throw runtime_error(OPERATION_FAILED);
         }
-        return result;
     }
 
-    static BigInt perform(
-        const BinaryOperationWithContext& op, const BigInt& a, const BigInt& b
+    template<auto operation>
+    static void apply(
+        BIGNUM* result, const BigInt& a, const BigInt& b, const Context& ctx
     ) {
-        Context ctx;
-        BigInt result;
-        if (!op(result.data, a.data, b.data, ctx.data)) {
+        const Context::Frame frame(ctx);
+        if (!operation(result, a.input(ctx), b.input(ctx), ctx.data)) {
             throw runtime_error(OPERATION_FAILED);
         }
-        return result;
     }
 
-    static BigInt perform(
-        const BinaryOperationWithWord& op, const BigInt& a, const Word& w
-    ) {
-        BigInt result(a);
-        if (!op(result.data, w)) {
+    template<auto operation>
+    static void apply(BIGNUM* result, const BigInt& a, const Word& w) {
+        if (result != a.data) {
+            const bool copied = a.isSmall()
+                ? BN_set_word(result, a.small)
+                : BN_copy(result, a.data) != nullptr;
+            if (!copied) {
+                throw runtime_error(OPERATION_FAILED);
+            }
+        }
+        if (!operation(result, w)) {
             throw runtime_error(OPERATION_FAILED);
         }
-        return result;
     }
 
-    static BigInt perform(
-        const TernaryOperationWithContext& op,
+    template<auto operation>
+    static void apply(
+        BIGNUM* result,
         const BigInt& a,
         const BigInt& b,
-        const BigInt& c
+        const BigInt& c,
+        const Context& ctx
     ) {
-        Context ctx;
-        BigInt result;
-        if (!op(result.data, a.data, b.data, c.data, ctx.data)) {
+        const Context::Frame frame(ctx);
+        if (!operation(
+            result, a.input(ctx), b.input(ctx), c.input(ctx), ctx.data
+        )) {
             throw runtime_error(OPERATION_FAILED);
         }
+    }
+
+    static int computeRemainder(
+        BIGNUM* result, const BIGNUM* a, const BIGNUM* d, BN_CTX* ctx
+    ) {
+        return BN_mod(result, a, d, ctx);
+    }
+
+    static int computeQuotient(
+        BIGNUM* result, const BIGNUM* a, const BIGNUM* d, BN_CTX* ctx
+    ) {
+        return BN_div(result, nullptr, a, d, ctx);
+    }
+
+    template<auto operation, class... Operands>
+    static BigInt perform(const BigInt& a, const Operands&... operands) {
+        BigInt result;
+        apply<operation>(result.output(), a, operands...);
         return result;
     }
 
-public:
-    BigInt() {
-        this->data = BN_new();
-        if (!this->data) {
-            throw bad_alloc();
+    template<auto operation, class... Operands>
+    BigInt& performInPlace(const Operands&... operands) {
+        apply<operation>(this->output(), *this, operands...);
+        return *this;
+    }
+
+    bool tryAddInline(const Word& word) {
+        if (!this->isSmall() || word > MAX_WORD - this->small) {
+            return false;
+        }
+        this->small += word;
+        return true;
+    }
+
+    bool trySubtractInline(const Word& word) {
+        if (!this->isSmall() || word > this->small) {
+            return false;
+        }
+        this->small -= word;
+        return true;
+    }
+
+    bool tryMultiplyInline(const Word& word) {
+        if (!this->isSmall() || (word && this->small > MAX_WORD / word)) {
+            return false;
         }
+        this->small *= word;
+        return true;
     }
 
-    BigInt(const BigInt& other) : BigInt() {
-        BN_copy(this->data, other.data);
+public:
+    BigInt() {}
+
+    BigInt(const BigInt& other) : small(other.small) {
+        if (other.data) {
+            this->data = BN_dup(other.data);
+            if (!this->data) {
+                throw bad_alloc();
+            }
+        }
     }
 
-    BigInt(const Word& word) : BigInt() {
-        BN_set_word(this->data, word);
+    /**
+     * Takes over the BIGNUM of the other number without allocating.
+     * The moved-from number is left equal to zero.
+     */
+    BigInt(BigInt&& other) noexcept : data(other.data), small(other.small) {
+        other.data = nullptr;
+        other.small = 0;
     }
 
+    BigInt(const Word& word) : small(word) {}
+
     BigInt(const string& str, const Radix& radix = Radix::DEC) : BigInt() {
         const auto throwInvalidArgument = [&]() {
             throw invalid_argument(
@@ -165,7 +388,7 @@ public:
             if (!BN_bin2bn(
                 reinterpret_cast<const unsigned char *>(bytes.data()),
                 bytes.size(),
-                this->data)
+                this->output())
             ) {
                 throwInvalidArgument();
             }
@@ -189,6 +412,15 @@ public:
     }
 
     string toString(const Radix& radix = Radix::DEC) const {
+        if (this->isSmall()) {
+            if (radix == Radix::DEC) {
+                return to_string(this->small);
+            }
+            BigInt copy(*this);
+            copy.output();
+            return copy.toString(radix);
+        }
+
         string result("");
         if (radix == Radix::BIN) {
             char* str = new char[BN_num_bytes(this->data) + 1];
@@ -229,6 +461,11 @@ public:
     }
 
     OctetString toOctetString() const {
+        if (this->isSmall()) {
+            BigInt copy(*this);
+            copy.output();
+            return copy.toOctetString();
+        }
         OctetString str(BN_num_bytes(this->data));
         const int length = BN_bn2bin(
             this->data, reinterpret_cast<unsigned char*>(str.data())
@@ -236,92 +473,270 @@ public:
         return str;
     }
 
+    /**
+     * Big-endian encoding left-padded with zeros to the given length.
+     */
+    OctetString toOctetString(const size_t length) const {
+        const Context ctx;
+        const Context::Frame frame(ctx);
+        OctetString str(length);
+        if (BN_bn2binpad(this->input(ctx), str.data(), length) < 0) {
+            throw invalid_argument(
+                "The 'length' parameter must be at least "
+                + to_string(BN_num_bytes(this->input(ctx)))
+            );
+        }
+        return str;
+    }
+
+    /**
+     * Reads an unsigned big-endian integer.
+     */
+    static BigInt fromOctetString(span<const Byte> str) {
+        BigInt result;
+        if (!BN_bin2bn(str.data(), str.size(), result.output())) {
+            throw runtime_error(OPERATION_FAILED);
+        }
+        return result;
+    }
+
+    /**
+     * Reads the leftmost numberOfBits bits of the octets as an unsigned
+     * integer, or all of them if there are fewer. This is bits2int of
+     * RFC 6979 and the truncation of a digest in ECDSA.
+     */
+    static BigInt fromOctetString(span<const Byte> str, const size_t numberOfBits) {
+        const size_t length = min(
+            str.size(), (numberOfBits + BITS_PER_BYTE - 1) / BITS_PER_BYTE
+        );
+        BigInt result = fromOctetString(str.first(length));
+        if (length * BITS_PER_BYTE > numberOfBits) {
+            const size_t shift = length * BITS_PER_BYTE - numberOfBits;
+            result = result / (Word(1) << shift);
+        }
+        return result;
+    }
+
+    size_t getNumberOfBits() const {
+        if (this->isSmall()) {
+            return bit_width(this->small);
+        }
+        return BN_num_bits(this->data);
+    }
+
     BigInt& operator=(const BigInt& other) {
-        if (this != &other) {
-            BN_clear(this->data);
-            BN_copy(this->data, other.data);
+        if (this == &other) {
+            return *this;
         }
+        if (other.isSmall()) {
+            if (this->data) {
+                BN_set_word(this->data, other.small);
+            } else {
+                this->small = other.small;
+            }
+        } else if (!BN_copy(this->output(), other.data)) {
+            throw runtime_error(OPERATION_FAILED);
+        }
+        return *this;
+    }
+
+    BigInt& operator=(BigInt&& other) noexcept {
+        swap(this->data, other.data);
+        swap(this->small, other.small);
         return *this;
     }
 
     BigInt operator-() const {
         BigInt result(*this);
-        BN_set_negative(result.data, !BN_is_negative(result.data));
+        if (result.isSmall() && !result.small) {
+            return result;
+        }
+        BIGNUM* data = result.output();
+        BN_set_negative(data, !BN_is_negative(data));
         return result;
     }
 
-    BigInt operator+(const BigInt& other) const {
-        return perform(BN_add, *this, other);
+    BigInt operator+(const BigInt& other) const& {
+        if (other.isSmall()) {
+            return *this + other.small;
+        }
+        return perform<BN_add>(*this, other);
+    }
+
+    BigInt operator+(const BigInt& other) && {
+        return move(*this += other);
     }
 
-    BigInt operator-(const BigInt& other) const {
-        return perform(BN_sub, *this, other);
+    BigInt operator-(const BigInt& other) const& {
+        if (other.isSmall()) {
+            return *this - other.small;
+        }
+        return perform<BN_sub>(*this, other);
     }
 
-    BigInt operator*(const BigInt& other) const {
-        return perform(BN_mul, *this, other);
+    BigInt operator-(const BigInt& other) && {
+        return move(*this -= other);
+    }
+
+    BigInt operator*(const BigInt& other) const& {
+        if (other.isSmall()) {
+            return *this * other.small;
+        }
+        return perform<BN_mul>(*this, other);
+    }
+
+    BigInt operator*(const BigInt& other) && {
+        return move(*this *= other);
     }
 
     BigInt operator/(const BigInt& other) const {
-        Context ctx;
-        BigInt result;
-        if (!BN_div(result.data, nullptr, this->data, other.data, ctx.data)) {
-            throw runtime_error(OPERATION_FAILED);
+        if (this->isSmall() && other.isSmall() && other.small) {
+            return this->small / other.small;
         }
-        return result;
+        return perform<computeQuotient>(*this, other);
     }
 
     BigInt operator%(const BigInt& other) const {
-        Context ctx;
-        BigInt result;
-        if (!BN_mod(result.data, this->data, other.data, ctx.data)) {
-            throw runtime_error(OPERATION_FAILED);
+        if (this->isSmall() && other.isSmall() && other.small) {
+            return this->small % other.small;
         }
-        return result;
+        return perform<computeRemainder>(*this, other);
     }
 
-    BigInt operator+(const Word& word) const {
-        return perform(BN_add_word, *this, word);
+    BigInt operator+(const Word& word) const& {
+        BigInt result(*this);
+        return move(result += word);
     }
 
-    BigInt operator-(const Word& word) const {
-        return perform(BN_sub_word, *this, word);
+    BigInt operator+(const Word& word) && {
+        return move(*this += word);
     }
 
-    BigInt operator*(const Word& word) const {
-        return perform(BN_mul_word, *this, word);
+    BigInt operator-(const Word& word) const& {
+        BigInt result(*this);
+        return move(result -= word);
+    }
+
+    BigInt operator-(const Word& word) && {
+        return move(*this -= word);
+    }
+
+    BigInt operator*(const Word& word) const& {
+        BigInt result(*this);
+        return move(result *= word);
+    }
+
+    BigInt operator*(const Word& word) && {
+        return move(*this *= word);
     }
 
     BigInt operator/(const Word& word) const {
-        return perform(BN_div_word, *this, word);
+        if (this->isSmall() && word) {
+            return this->small / word;
+        }
+        BigInt result(*this);
+        if (BN_div_word(result.output(), word) == static_cast<Word>(-1)) {
+            throw runtime_error(OPERATION_FAILED);
+        }
+        return result;
     }
 
     BigInt operator%(const Word& word) const {
-        return perform(BN_mod_word, *this, word);
+        if (this->isSmall() && word) {
+            return this->small % word;
+        }
+        const Word remainder = this->isSmall()
+            ? static_cast<Word>(-1) : BN_mod_word(this->data, word);
+        if (remainder == static_cast<Word>(-1)) {
+            throw runtime_error(OPERATION_FAILED);
+        }
+        return remainder;
+    }
+
+    BigInt& operator+=(const BigInt& other) {
+        if (other.isSmall()) {
+            return *this += other.small;
+        }
+        return this->performInPlace<BN_add>(other);
+    }
+
+    BigInt& operator-=(const BigInt& other) {
+        if (other.isSmall()) {
+            return *this -= other.small;
+        }
+        return this->performInPlace<BN_sub>(other);
+    }
+
+    BigInt& operator*=(const BigInt& other) {
+        if (other.isSmall()) {
+            return *this *= other.small;
+        }
+        return this->performInPlace<BN_mul>(other);
+    }
+
+    BigInt& operator%=(const BigInt& other) {
+        if (this->isSmall() && other.isSmall() && other.small) {
+            this->small %= other.small;
+            return *this;
+        }
+        return this->performInPlace<computeRemainder>(other);
+    }
+
+    BigInt& operator+=(const Word& word) {
+        if (this->tryAddInline(word)) {
+            return *this;
+        }
+        return this->performInPlace<BN_add_word>(word);
+    }
+
+    BigInt& operator-=(const Word& word) {
+        if (this->trySubtractInline(word)) {
+            return *this;
+        }
+        return this->performInPlace<BN_sub_word>(word);
+    }
+
+    BigInt& operator*=(const Word& word) {
+        if (this->tryMultiplyInline(word)) {
+            return *this;
+        }
+        return this->performInPlace<BN_mul_word>(word);
+    }
+
+    BigInt& mulModInPlace(
+        const BigInt& other, const BigInt& m, const Context& ctx = Context()
+    ) {
+        return this->performInPlace<BN_mod_mul>(other, m, ctx);
+    }
+
+    BigInt& powModInPlace(
+        const BigInt& p, const BigInt& m, const Context& ctx = Context()
+    ) {
+        return this->performInPlace<BN_mod_exp>(p, m, ctx);
     }
 
     bool operator<(const BigInt& other) const {
-        return BN_cmp(this->data, other.data) == -1;
+        return this->compare(other) < 0;
     }
 
     bool operator<(const Word& word) const {
-        return BN_cmp(this->data, BigInt(word).data) == -1;
+        return this->compare(word) < 0;
     }
 
     bool operator>(const BigInt& other) const {
-        return BN_cmp(this->data, other.data) == 1;
+        return this->compare(other) > 0;
     }
 
     bool operator>(const Word& word) const {
-        return BN_cmp(this->data, BigInt(word).data) == 1;
+        return this->compare(word) > 0;
     }
 
     bool operator==(const BigInt& other) const {
-        return BN_cmp(this->data, other.data) == 0;
+        return this->compare(other) == 0;
     }
 
     bool operator==(const Word& word) const {
-        return BN_cmp(this->data, BigInt(word).data) == 0;
+        return this->compare(word) == 0;
     }
 
     bool operator!=(const Word& word) const {
@@ -329,38 +744,87 @@ public:
     }
 
     explicit operator Word() const {
-        return BN_get_word(this->data);
+        return this->isSmall() ? this->small : BN_get_word(this->data);
     }
 
     operator string() const {
         return this->toString();
     }
 
-    static BigInt mod(const BigInt& a, const BigInt& m) {
-        return perform(BN_nnmod, a, m);
+    static BigInt mod(
+        const BigInt& a, const BigInt& m, const Context& ctx = Context()
+    ) {
+        return perform<BN_nnmod>(a, m, ctx);
     }
 
-    static BigInt mulMod(const BigInt& a, const BigInt& b,  const BigInt& m) {
-        return perform(BN_mod_mul, a, b, m);
+    static BigInt mulMod(
+        const BigInt& a,
+        const BigInt& b,
+        const BigInt& m,
+        const Context& ctx = Context()
+    ) {
+        return perform<BN_mod_mul>(a, b, m, ctx);
     }
 
-    static BigInt powMod(const BigInt& a, const BigInt& p,  const BigInt& m) {
-        return perform(BN_mod_exp, a, p, m);
+    static BigInt powMod(
+        const BigInt& a,
+        const BigInt& p,
+        const BigInt& m,
+        const Context& ctx = Context()
+    ) {
+        return perform<BN_mod_exp>(a, p, m, ctx);
     }
 
-    static BigInt computeInverseModulo(const BigInt& a, const BigInt& n) {
-        Context ctx;
+    static BigInt computeInverseModulo(
+        const BigInt& a, const BigInt& n, const Context& ctx = Context()
+    ) {
         BigInt result;
-        if (!BN_mod_inverse(result.data, a.data, n.data, ctx.data)) {
+        const Context::Frame frame(ctx);
+        if (!BN_mod_inverse(
+            result.output(), a.input(ctx), n.input(ctx), ctx.data
+        )) {
             throw runtime_error(OPERATION_FAILED);
         }
         return result;
     }
 
+    /**
+     * Inverts every value modulo n with Montgomery's trick: one modular
+     * inversion of the product of all values and 3(N - 1) modular
+     * multiplications. Fails if any of the values is not invertible.
+     */
+    static vector<BigInt> batchInverseModulo(
+        span<const BigInt> values,
+        const BigInt& n,
+        const Context& ctx = Context()
+    ) {
+        vector<BigInt> result(values.size());
+        if (values.empty()) {
+            return result;
+        }
+
+        result[0] = values[0];
+        for (size_t i = 1; i < values.size(); ++i) {
+            apply<BN_mod_mul>(
+                result[i].output(), result[i - 1], values[i], n, ctx
+            );
+        }
+
+        BigInt inverse = computeInverseModulo(result.back(), n, ctx);
+        for (size_t i = values.size() - 1; i > 0; --i) {
+            apply<BN_mod_mul>(
+                result[i].output(), inverse, result[i - 1], n, ctx
+            );
+            inverse.mulModInPlace(values[i], n, ctx);
+        }
+        result[0] = move(inverse);
+        return result;
+    }
+
     static BigInt generatePrime(const size_t length) {
         BigInt result;
         if (!BN_generate_prime_ex(
-            result.data, length, false, nullptr, nullptr, nullptr
+            result.output(), length, false, nullptr, nullptr, nullptr
         )) {
             throw runtime_error(OPERATION_FAILED);
         }
@@ -368,9 +832,9 @@ public:
     }
 
     static BigInt computeGreatestCommonDivisor(
-        const BigInt& a, const BigInt& b
+        const BigInt& a, const BigInt& b, const Context& ctx = Context()
     ) {
-        return perform(BN_gcd, a, b);
+        return perform<BN_gcd>(a, b, ctx);
     }
 
     static BigInt generateInRange(
@@ -378,10 +842,12 @@ public:
     ) {
         const BigInt range = max - min + 1;
         BigInt result;
-        if (!BN_rand_range(result.data, range.data)) {
+        const Context ctx;
+        const Context::Frame frame(ctx);
+        if (!BN_rand_range(result.output(), range.input(ctx))) {
             throw runtime_error(OPERATION_FAILED);
         }
-        return result + min;
+        return move(result += min);
     }
 
     static BigInt generateInInterval(
@@ -392,12 +858,16 @@ public:
 
     static BigInt mask(const BigInt& a, size_t n) {
         BigInt result(a);
-        BN_mask_bits(result.data, n);
+        BN_mask_bits(result.output(), n);
         return result;
     }
 };
 
 ostream& operator<<(ostream& out, const BigInt& bigInt) {
+    if (bigInt.isSmall()) {
+        out << bigInt.small;
+        return out;
+    }
     char* str = BN_bn2dec(bigInt.data);
     out << str;
     OPENSSL_clear_free(str, 0);
@@ -0,0 +1,39 @@
+#ifndef COMMITTED_SIGNED_MESSAGE_H_INCLUDED
+#define COMMITTED_SIGNED_MESSAGE_H_INCLUDED
+
+#include "../definitions.h"
+#include "point.h"
+#include "signed-message.h"
+
+namespace EllipticCryptography {
+    /**
+     * EC-Schnorr signed message that also carries the commitment R = k * G
+     * the challenge was computed from. Knowing R turns verification into
+     * the linear equation s * G + r * Q = R, which lets many signatures be
+     * checked together.
+     */
+    class CommittedSignedMessage : public SignedMessage<OctetString> {
+    private:
+        Point commitment;
+
+    public:
+        CommittedSignedMessage(
+            const OctetString& message,
+            const Signature& signature,
+            const Point& commitment
+        )
+        :   SignedMessage(message, signature),
+            commitment(commitment)
+        {}
+
+        const Point& getCommitment() const {
+            return this->commitment;
+        }
+
+        Point& getCommitment() {
+            return this->commitment;
+        }
+    };
+}
+
+#endif // COMMITTED_SIGNED_MESSAGE_H_INCLUDED
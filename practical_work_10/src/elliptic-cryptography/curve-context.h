@@ -0,0 +1,389 @@
+#ifndef CURVE_CONTEXT_H_INCLUDED
+#define CURVE_CONTEXT_H_INCLUDED
+
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <stdexcept>
+#include <vector>
+#include <openssl/ec.h>
+#include <openssl/obj_mac.h>
+#include "../definitions.h"
+#include "../big-int.h"
+#include "fixed-base-multiplication.h"
+#include "group.h"
+#include "point.h"
+#include "secp256k1/engine.h"
+
+using namespace std;
+
+namespace EllipticCryptography {
+    const string INVALID_POINT_ENCODING =
+        "The 'encoded' parameter is not a valid encoding of a point of the curve";
+    /**
+     * The table of the base point is built once per curve, so it gets a
+     * wider window than the default.
+     */
+    const size_t BASE_POINT_WINDOW_WIDTH = 6;
+
+    /**
+     * Parameters of a curve, read from the group once and shared by every
+     * copy of the curve and by the algorithms built on top of it.
+     * A custom curve has no base point until one is set on its group, so
+     * the base point, its order and the cofactor are optional and their
+     * getters fail if they are missing.
+     */
+    class CurveContext {
+    private:
+        shared_ptr<const Group> group;
+        BigInt p;
+        BigInt a;
+        BigInt b;
+        BigInt basePointOrder;
+        BigInt cofactor;
+        BigInt order;
+        size_t fieldSize;
+        /**
+         * (p + 1) / 4 if the field is prime and p = 3 (mod 4), else 0.
+         */
+        BigInt squareRootExponent;
+        /**
+         * Whether OpenSSL ships a precomputed table of multiples of the
+         * base point for this group, as its nistz256 code does for P-256.
+         */
+        bool hasBuiltinBasePointTable;
+        optional<Point> basePoint;
+        mutable once_flag basePointMultiplesFlag;
+        mutable unique_ptr<const FixedBaseMultiplication> basePointMultiples;
+
+    private:
+        void requireBasePoint() const {
+            if (!this->basePoint) {
+                throw runtime_error(OPERATION_FAILED);
+            }
+        }
+
+        /**
+         * Computes k * G for a public k. Curves for which OpenSSL has its
+         * own table of G go to EC_POINT_mul, on the others a table of
+         * multiples of the base point is built on the first call and
+         * shared by all the later ones. The running time depends on k.
+         */
+        Point multiplyBasePointVariableTime(
+            const BigInt& k, const BigInt::Context& ctx
+        ) const {
+            if (this->hasBuiltinBasePointTable) {
+                return this->multiplyBasePoint(k, ctx);
+            }
+            call_once(this->basePointMultiplesFlag, [this] {
+                this->basePointMultiples =
+                    make_unique<const FixedBaseMultiplication>(
+                        *this->basePoint,
+                        this->basePointOrder,
+                        BASE_POINT_WINDOW_WIDTH
+                    );
+            });
+            return this->basePointMultiples->multiply(k, ctx);
+        }
+
+    public:
+        CurveContext(shared_ptr<const Group> group) : group(group) {
+            const BigInt::Context ctx;
+            if (!EC_GROUP_get_curve(
+                this->group->get(),
+                this->p.output(),
+                this->a.output(),
+                this->b.output(),
+                ctx.data
+            )) {
+                throw runtime_error(OPERATION_FAILED);
+            }
+            const EC_POINT* generator = EC_GROUP_get0_generator(this->group->get());
+            if (generator) {
+                if (
+                    !EC_GROUP_get_order(
+                        this->group->get(), this->basePointOrder.output(), ctx.data
+                    )
+                    ||
+                    !EC_GROUP_get_cofactor(
+                        this->group->get(), this->cofactor.output(), ctx.data
+                    )
+                ) {
+                    throw runtime_error(OPERATION_FAILED);
+                }
+                this->order = this->cofactor * this->basePointOrder;
+                this->basePoint = Point(generator, this->group);
+                this->basePoint->markAffine();
+            }
+            this->fieldSize = (EC_GROUP_get_degree(this->group->get()) + 7) / 8;
+            if (
+                EC_GROUP_get_field_type(this->group->get()) == NID_X9_62_prime_field
+                && this->p % 4 == 3
+            ) {
+                this->squareRootExponent = (this->p + 1) / 4;
+            }
+            // Deprecated like EC_POINTs_make_affine in Point::normalizeBatch.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+            this->hasBuiltinBasePointTable =
+                EC_GROUP_have_precompute_mult(this->group->get()) == 1;
+#pragma GCC diagnostic pop
+        }
+
+        CurveContext(const CurveContext& other) = delete;
+
+        CurveContext& operator=(const CurveContext& other) = delete;
+
+        const shared_ptr<const Group>& getGroup() const {
+            return this->group;
+        }
+
+        const BigInt& getP() const {
+            return this->p;
+        }
+
+        const BigInt& getA() const {
+            return this->a;
+        }
+
+        const BigInt& getB() const {
+            return this->b;
+        }
+
+        bool hasBasePoint() const {
+            return this->basePoint.has_value();
+        }
+
+        const BigInt& getBasePointOrder() const {
+            this->requireBasePoint();
+            return this->basePointOrder;
+        }
+
+        const BigInt& getCofactor() const {
+            this->requireBasePoint();
+            return this->cofactor;
+        }
+
+        const BigInt& getOrder() const {
+            this->requireBasePoint();
+            return this->order;
+        }
+
+        const Point& getBasePoint() const {
+            this->requireBasePoint();
+            return *this->basePoint;
+        }
+
+        /**
+         * Decodes a SEC1 point encoding and checks that the point is on
+         * the curve. Compressed points are recovered with the native
+         * square root on secp256k1, with a single exponentiation on other
+         * curves where p = 3 (mod 4), and by OpenSSL otherwise.
+         */
+        Point decodePoint(
+            span<const Byte> encoded, const BigInt::Context& ctx = BigInt::Context()
+        ) const {
+            Point result(this->group);
+            const bool isCompressed =
+                encoded.size() == 1 + this->fieldSize
+                && (
+                    encoded[0] == POINT_CONVERSION_COMPRESSED
+                    || encoded[0] == (POINT_CONVERSION_COMPRESSED | 1)
+                );
+            const bool isYOdd = encoded.size() && (encoded[0] & 1);
+            if (
+                isCompressed
+                && Secp256k1::Engine::isSupported(this->group->get())
+            ) {
+                if (!Secp256k1::Engine::decompress(
+                    this->group->get(),
+                    result.data,
+                    encoded.subspan<1, Secp256k1::FIELD_ELEMENT_SIZE>(),
+                    isYOdd,
+                    ctx.data
+                )) {
+                    throw invalid_argument(INVALID_POINT_ENCODING);
+                }
+            } else if (isCompressed && !(this->squareRootExponent == 0)) {
+                const BigInt::Context::Frame frame(ctx);
+                BigInt x;
+                if (!BN_bin2bn(encoded.data() + 1, this->fieldSize, x.output())) {
+                    throw runtime_error(OPERATION_FAILED);
+                }
+                if (!(x < this->p)) {
+                    throw invalid_argument(INVALID_POINT_ENCODING);
+                }
+                BigInt rhs = BigInt::mulMod(x, x, this->p, ctx);
+                rhs += this->a;
+                rhs.mulModInPlace(x, this->p, ctx);
+                rhs += this->b;
+                rhs = BigInt::mod(rhs, this->p, ctx);
+                BigInt y = BigInt::powMod(rhs, this->squareRootExponent, this->p, ctx);
+                if (!(BigInt::mulMod(y, y, this->p, ctx) == rhs)) {
+                    throw invalid_argument(INVALID_POINT_ENCODING);
+                }
+                if (BN_is_odd(y.input(ctx)) != isYOdd) {
+                    if (y == 0) {
+                        throw invalid_argument(INVALID_POINT_ENCODING);
+                    }
+                    y = this->p - y;
+                }
+                if (!EC_POINT_set_affine_coordinates(
+                    this->group->get(),
+                    result.data,
+                    x.input(ctx),
+                    y.input(ctx),
+                    ctx.data
+                )) {
+                    throw runtime_error(OPERATION_FAILED);
+                }
+            } else if (!EC_POINT_oct2point(
+                this->group->get(),
+                result.data,
+                encoded.data(),
+                encoded.size(),
+                ctx.data
+            )) {
+                throw invalid_argument(INVALID_POINT_ENCODING);
+            }
+            result.markAffine();
+            return result;
+        }
+
+        /**
+         * Decodes points stored back to back, encodedSize bytes each, and
+         * checks that all of them are on the curve. Fails on the first
+         * invalid encoding and names its index.
+         */
+        vector<Point> decodePoints(
+            span<const Byte> encodedPoints,
+            const size_t encodedSize,
+            const BigInt::Context& ctx = BigInt::Context()
+        ) const {
+            if (encodedSize == 0 || encodedPoints.size() % encodedSize) {
+                throw invalid_argument(
+                    "The 'encodedSize' parameter cannot be equal to "
+                    + to_string(encodedSize)
+                );
+            }
+            vector<Point> result;
+            result.reserve(encodedPoints.size() / encodedSize);
+            for (size_t i = 0; i < encodedPoints.size(); i += encodedSize) {
+                try {
+                    result.push_back(
+                        this->decodePoint(encodedPoints.subspan(i, encodedSize), ctx)
+                    );
+                } catch (const invalid_argument&) {
+                    throw invalid_argument(
+                        "The point at index " + to_string(i / encodedSize)
+                        + " has an invalid encoding"
+                    );
+                }
+            }
+            return result;
+        }
+
+        /**
+         * Computes k * G for a secret k, such as a nonce or a private key.
+         * Both the native engine on secp256k1 and EC_POINT_mul, whose
+         * ladder serves the other curves, run in time independent of k.
+         */
+        Point multiplyBasePoint(
+            const BigInt& k, const BigInt::Context& ctx = BigInt::Context()
+        ) const {
+            this->requireBasePoint();
+            Point result(this->group);
+            if (Secp256k1::Engine::isSupported(this->group->get())) {
+                Secp256k1::Engine::multiplyGenerator(
+                    this->group->get(), result.data, k, ctx
+                );
+                result.markAffine();
+                return result;
+            }
+            const BigInt::Context::Frame frame(ctx);
+            if (!EC_POINT_mul(
+                this->group->get(),
+                result.data,
+                k.input(ctx),
+                nullptr,
+                nullptr,
+                ctx.data
+            )) {
+                throw runtime_error(OPERATION_FAILED);
+            }
+            return result;
+        }
+
+        /**
+         * Computes u1 * G + u2 * Q with a single interleaved chain of
+         * doublings instead of two independent multiplications.
+         */
+        Point mulAdd(
+            const BigInt& u1,
+            const BigInt& u2,
+            const Point& Q,
+            const BigInt::Context& ctx = BigInt::Context()
+        ) const {
+            if (Q.group != this->group) {
+                throw runtime_error(OPERATION_FAILED);
+            }
+            Point result(this->group);
+            if (Secp256k1::Engine::isSupported(this->group->get())) {
+                Secp256k1::Engine::mulAdd(
+                    this->group->get(), result.data, u1, u2, Q.data, ctx
+                );
+                result.markAffine();
+                return result;
+            }
+            const BigInt::Context::Frame frame(ctx);
+            if (!EC_POINT_mul(
+                this->group->get(),
+                result.data,
+                u1.input(ctx),
+                Q.data,
+                u2.input(ctx),
+                ctx.data
+            )) {
+                throw runtime_error(OPERATION_FAILED);
+            }
+            return result;
+        }
+
+        /**
+         * Computes u1 * G + u2 * Q from a table of multiples of Q. On
+         * secp256k1 both halves come from comb tables and share a single
+         * accumulator, which costs about as much as one multiplication of
+         * the base point.
+         */
+        Point mulAdd(
+            const BigInt& u1,
+            const BigInt& u2,
+            const FixedBaseMultiplication& QMultiples,
+            const BigInt::Context& ctx = BigInt::Context()
+        ) const {
+            if (QMultiples.base.group != this->group) {
+                throw runtime_error(OPERATION_FAILED);
+            }
+            if (!QMultiples.nativeTable.empty()) {
+                Point result(this->group);
+                Secp256k1::Engine::mulAdd(
+                    this->group->get(),
+                    result.data,
+                    u1,
+                    u2,
+                    QMultiples.nativeTable,
+                    QMultiples.windowWidth,
+                    ctx
+                );
+                result.markAffine();
+                return result;
+            }
+            return this->multiplyBasePointVariableTime(u1, ctx)
+                + QMultiples.multiply(u2, ctx);
+        }
+    };
+}
+
+#endif // CURVE_CONTEXT_H_INCLUDED
@@ -1,13 +1,21 @@
 #ifndef CURVE_H_INCLUDED
 #define CURVE_H_INCLUDED
 
+#include <array>
+#include <memory>
+#include <mutex>
+#include <span>
 #include <stdexcept>
+#include <string>
+#include <vector>
 #include <openssl/ec.h>
 #include <openssl/obj_mac.h>
+#include <openssl/objects.h>
 #include "../definitions.h"
 #include "../big-int.h"
+#include "curve-context.h"
+#include "group.h"
 #include "point.h"
-#include "shared.h"
 
 using namespace std;
 
@@ -19,76 +27,86 @@ namespace EllipticCryptography {
         friend class Point;
 
     protected:
-        EC_GROUP* group = nullptr;
+        shared_ptr<const CurveContext> context;
 
     protected:
-        Curve(const EC_GROUP* group)
-        :   group(EC_GROUP_dup(group))
-        {
-            if (!this->group) {
-                throw runtime_error(OPERATION_FAILED);
-            }
-        }
+        /**
+         * Takes ownership of the group.
+         */
+        Curve(EC_GROUP* group)
+        :   context(make_shared<const CurveContext>(Group::intern(group)))
+        {}
+
+        Curve(shared_ptr<const CurveContext> context) : context(move(context)) {}
 
     private:
-        BigInt getCofactor() const {
-            BigInt result;
-            if (!EC_GROUP_get_cofactor(
-                this->group, result.data, BigInt::Context().data
-            )) {
-                throw runtime_error(OPERATION_FAILED);
-            }
-            return result;
+        static EC_GROUP* createGroup(
+            const BigInt& p, const BigInt& a, const BigInt& b
+        ) {
+            const BigInt::Context ctx;
+            const BigInt::Context::Frame frame(ctx);
+            return EC_GROUP_new_curve_GFp(
+                p.input(ctx), a.input(ctx), b.input(ctx), ctx.data
+            );
         }
 
     public:
         Curve(const BigInt& p, const BigInt& a, const BigInt& b)
-        :   group(EC_GROUP_new_curve_GFp(
-                p.data, a.data, b.data, BigInt::Context().data
-            ))
-        {
-            if (!this->group) {
-                throw runtime_error(OPERATION_FAILED);
-            }
+        :   Curve(createGroup(p, a, b))
+        {}
+
+        virtual ~Curve() = default;
+
+        const shared_ptr<const CurveContext>& getContext() const {
+            return this->context;
         }
 
-        Curve(const Curve& other)
-        :   group(EC_GROUP_dup(other.group))
-        {
-            if (!this->group) {
-                throw runtime_error(OPERATION_FAILED);
-            }
+        const BigInt& getBasePointOrder() const {
+            return this->context->getBasePointOrder();
         }
 
-        virtual ~Curve() {
-            EC_GROUP_free(this->group);
+        const BigInt& getOrder() const {
+            return this->context->getOrder();
         }
 
-        BigInt getBasePointOrder() const {
-            BigInt result;
-            if (!EC_GROUP_get_order(
-                this->group, result.data, BigInt::Context().data
-            )) {
-                throw runtime_error(OPERATION_FAILED);
-            }
-            return result;
+        const Point& getBasePoint() const {
+            return this->context->getBasePoint();
         }
 
-        BigInt getOrder() const {
-            return this->getCofactor() * this->getBasePointOrder();
+        Point multiplyBasePoint(
+            const BigInt& k, const BigInt::Context& ctx = BigInt::Context()
+        ) const {
+            return this->context->multiplyBasePoint(k, ctx);
         }
 
-        Point getBasePoint() const {
-            Point point(EC_GROUP_get0_generator(this->group), this->group);
-            if (!point.data) {
-                throw runtime_error(OPERATION_FAILED);
-            }
-            return point;
+        Point mulAdd(
+            const BigInt& u1,
+            const BigInt& u2,
+            const Point& Q,
+            const BigInt::Context& ctx = BigInt::Context()
+        ) const {
+            return this->context->mulAdd(u1, u2, Q, ctx);
+        }
+
+        Point decodePoint(
+            span<const Byte> encoded, const BigInt::Context& ctx = BigInt::Context()
+        ) const {
+            return this->context->decodePoint(encoded, ctx);
         }
 
-        bool contains(const Point& point) const {
+        vector<Point> decodePoints(
+            span<const Byte> encodedPoints,
+            const size_t encodedSize,
+            const BigInt::Context& ctx = BigInt::Context()
+        ) const {
+            return this->context->decodePoints(encodedPoints, encodedSize, ctx);
+        }
+
+        bool contains(
+            const Point& point, const BigInt::Context& ctx = BigInt::Context()
+        ) const {
             const int result = EC_POINT_is_on_curve(
-                this->group, point.data, BigInt::Context().data
+                this->context->getGroup()->get(), point.data, ctx.data
             );
             if (result == -1) {
                 throw runtime_error(OPERATION_FAILED);
@@ -97,23 +115,11 @@ namespace EllipticCryptography {
         }
 
         bool isAtInfinity(const Point& point) const {
-            const int result = EC_POINT_is_at_infinity(
-                this->group, point.data
-            );
-            return result;
-        }
-
-        Curve& operator=(const Curve& other) {
-            if (this != &other) {
-                if (!EC_GROUP_copy(this->group, other.group)) {
-                    throw runtime_error(OPERATION_FAILED);
-                }
-            }
-            return *this;
+            return point.isAtInfinity();
         }
 
         bool operator==(const Curve& other) const {
-            return areEqual(this->group, other.group);
+            return this->context->getGroup() == other.context->getGroup();
         }
 
         bool operator!=(const Curve& other) const {
@@ -121,6 +127,13 @@ namespace EllipticCryptography {
         }
     };
 
+    /**
+     * Named curve from OpenSSL's builtin list. Every curve is set up once
+     * per process on its first lookup, later lookups share its context,
+     * including the table of multiples of the base point. The groups come
+     * from EC_GROUP_new_by_curve_name, so OpenSSL attaches its fastest
+     * implementation, e.g. nistz256 for P-256 where it is compiled in.
+     */
     class BuiltinCurve : public Curve {
     private:
         friend ostream& operator<<(ostream& out, const BuiltinCurve& curve);
@@ -128,44 +141,71 @@ namespace EllipticCryptography {
     public:
         enum class ID {
             SECP256K1 = NID_secp256k1,
+            P256 = NID_X9_62_prime256v1,
+            P384 = NID_secp384r1,
+            P521 = NID_secp521r1,
+        };
+
+    private:
+        struct Registration {
+            once_flag flag;
+            shared_ptr<const CurveContext> context;
+            string name;
         };
 
+        static const size_t NUMBER_OF_IDS = 4;
+
     private:
         int id;
         string name;
 
     private:
-        BuiltinCurve(const EC_GROUP* group, const int id, const string& name)
-        :   Curve(group),
+        BuiltinCurve(
+            shared_ptr<const CurveContext> context, const int id, const string& name
+        )
+        :   Curve(move(context)),
             id(id),
             name(name)
         {}
 
-    public:
-        static BuiltinCurve getById(const ID id) {
-            if (id != ID::SECP256K1) {
-                throw invalid_argument(
-                    "The 'id' parameter cannot be equal to "
-                    + to_string(static_cast<int>(id)));
+        static size_t getIndex(const ID id) {
+            switch (id) {
+                case ID::SECP256K1: return 0;
+                case ID::P256: return 1;
+                case ID::P384: return 2;
+                case ID::P521: return 3;
             }
+            throw invalid_argument(
+                "The 'id' parameter cannot be equal to "
+                + to_string(static_cast<int>(id)));
+        }
+
+        static string findName(const int nid) {
             EC_builtin_curve builtinCurves[MAX_NUMBER_OF_BUILTIN_CURVES];
-            size_t actualNumberOfBuiltinCurves =
+            const size_t actualNumberOfBuiltinCurves =
                 EC_get_builtin_curves(
                     builtinCurves, MAX_NUMBER_OF_BUILTIN_CURVES
                 );
-            int index = 0;
-            for (int i = 0; i < actualNumberOfBuiltinCurves; ++i) {
-                if (builtinCurves[i].nid == static_cast<int>(id)) {
-                    index = i;
-                    break;
+            for (size_t i = 0; i < actualNumberOfBuiltinCurves; ++i) {
+                if (builtinCurves[i].nid == nid) {
+                    return builtinCurves[i].comment;
                 }
             }
-            BuiltinCurve builtinCurve(
-                EC_GROUP_new_by_curve_name(builtinCurves[index].nid),
-                builtinCurves[index].nid,
-                builtinCurves[index].comment
-            );
-            return builtinCurve;
+            return OBJ_nid2sn(nid);
+        }
+
+    public:
+        static BuiltinCurve getById(const ID id) {
+            static array<Registration, NUMBER_OF_IDS> registrations;
+            Registration& registration = registrations[getIndex(id)];
+            const int nid = static_cast<int>(id);
+            call_once(registration.flag, [&registration, nid] {
+                registration.context = make_shared<const CurveContext>(
+                    Group::intern(EC_GROUP_new_by_curve_name(nid))
+                );
+                registration.name = findName(nid);
+            });
+            return BuiltinCurve(registration.context, nid, registration.name);
         }
 
         int getId() const {
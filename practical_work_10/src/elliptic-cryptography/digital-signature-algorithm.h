@@ -1,51 +1,190 @@
 #ifndef DIGITAL_SIGNATURE_ALGORITHM_H_INCLUDED
 #define DIGITAL_SIGNATURE_ALGORITHM_H_INCLUDED
 
+#include <span>
+#include <stdexcept>
+#include <vector>
+#include "../thread-pool.h"
 #include "signature-algorithm.h"
 
 namespace EllipticCryptography {
+    const size_t VERIFY_BATCH_SHARD_SIZE = 64;
+
     class DigitalSignatureAlgorithm : public SignatureAlgorithm {
+    private:
+        static bool isInRange(const Signature& signature, const BigInt& n) {
+            const BigInt& r = signature.getR();
+            const BigInt& s = signature.getS();
+            return r > 0 && r < n && s > 0 && s < n;
+        }
+
+        bool verify(
+            span<const Byte> message,
+            const Signature& signature,
+            const PublicKey& publicKey,
+            const BigInt& inverseS,
+            const BigInt::Context& ctx
+        ) const {
+            const BigInt& n = this->context->getBasePointOrder();
+            const BigInt m = this->getHashAsBigInt(message);
+            const BigInt& r = signature.getR();
+            const BigInt u1 = BigInt::mulMod(inverseS, m, n, ctx);
+            const BigInt u2 = BigInt::mulMod(inverseS, r, n, ctx);
+            const Point Q = this->mulAdd(u1, u2, publicKey, ctx);
+            if (Q.isAtInfinity()) {
+                return false;
+            }
+            const BigInt v = BigInt::mod(Q.getX(ctx), n, ctx);
+            return v == r;
+        }
+
     public:
         DigitalSignatureAlgorithm(const Curve& curve) : SignatureAlgorithm(curve) {}
 
-        virtual SignedMessage<OctetString> sign(const OctetString& message, const PrivateKey& privateKey) const override {
-            const BigInt n = this->curve.getBasePointOrder();
-            const Point G = this->curve.getBasePoint();
-            const BigInt m = getHashAsBigInt(message);
+        using SignatureAlgorithm::sign;
+        using SignatureAlgorithm::verify;
+
+        virtual Signature sign(span<const Byte> message, const PrivateKey& privateKey) const override {
+            const Arena::Scope scope;
+            const BigInt::Context ctx;
+            const BigInt& n = this->context->getBasePointOrder();
+            Digest digest;
+            const span<const Byte> hash =
+                span(digest).first(this->computeHash(message, digest));
+            const BigInt m = this->convertHashToBigInt(hash);
+            NonceGenerator nonceGenerator = this->createNonceGenerator(hash, privateKey);
             while (true) {
-                const BigInt k = BigInt::generateInRange(1, n - 1);
-                const Point Q = k * G;
-                const BigInt r = BigInt::mod(Q.getX(), n);
+                const BigInt k = nonceGenerator.next();
+                const Point Q = this->context->multiplyBasePoint(k, ctx);
+                BigInt r = Q.getX(ctx);
+                r %= n;
                 if (r == 0) {
                     continue;
                 }
-                const BigInt inverseK = BigInt::computeInverseModulo(k, n);
-                const BigInt s = BigInt::mulMod(inverseK, (r * privateKey + m), n);
+                BigInt s = r * privateKey;
+                s += m;
+                s.mulModInPlace(BigInt::computeInverseModulo(k, n, ctx), n, ctx);
                 if (s == 0) {
                     continue;
                 }
-                return SignedMessage(message, Signature(r, s));
+                return Signature(move(r), move(s));
             }
         }
 
-        virtual bool verify(const SignedMessage<OctetString>& signedMessage, const PublicKey& publicKey) const override {
-            const BigInt n = this->curve.getBasePointOrder();
-            const Point G = this->curve.getBasePoint();
-            const BigInt m = getHashAsBigInt(signedMessage.getMessage());
-            const BigInt r = signedMessage.getSignature().getR();
-            const BigInt s = signedMessage.getSignature().getS();
-            if (!(r > 0 && r < n && s > 0 && s < n)) {
-                return false;
+        /**
+         * Signs every message with the same private key. The nonce inverses
+         * of the whole batch are computed with a single modular inversion,
+         * and so are the affine coordinates of the nonce points.
+         */
+        vector<SignedMessage<OctetString>> signBatch(span<const OctetString> messages, const PrivateKey& privateKey) const {
+            const Arena::Scope scope;
+            const BigInt::Context ctx;
+            const BigInt& n = this->context->getBasePointOrder();
+            vector<NonceGenerator> nonceGenerators;
+            vector<BigInt> m(messages.size());
+            vector<BigInt> k(messages.size());
+            vector<Point> R;
+            nonceGenerators.reserve(messages.size());
+            R.reserve(messages.size());
+            for (size_t i = 0; i < messages.size(); ++i) {
+                Digest digest;
+                const span<const Byte> hash =
+                    span(digest).first(this->computeHash(messages[i], digest));
+                m[i] = this->convertHashToBigInt(hash);
+                nonceGenerators.push_back(this->createNonceGenerator(hash, privateKey));
+                k[i] = nonceGenerators[i].next();
+                R.push_back(this->context->multiplyBasePoint(k[i], ctx));
+            }
+            Point::normalizeBatch(R, ctx);
+            vector<BigInt> r(messages.size());
+            for (size_t i = 0; i < messages.size(); ++i) {
+                r[i] = R[i].getX(ctx);
+                r[i] %= n;
+                while (r[i] == 0) {
+                    k[i] = nonceGenerators[i].next();
+                    r[i] = this->context->multiplyBasePoint(k[i], ctx).getX(ctx);
+                    r[i] %= n;
+                }
             }
-            const BigInt inverseS = BigInt::computeInverseModulo(s, n);
-            const BigInt u1 = BigInt::mulMod(inverseS, m, n);
-            const BigInt u2 = BigInt::mulMod(inverseS, r, n);
-            const Point Q = u1 * G + u2 * publicKey;
-            if (this->curve.isAtInfinity(Q)) {
+            const vector<BigInt> inverseK = BigInt::batchInverseModulo(k, n, ctx);
+            vector<SignedMessage<OctetString>> signedMessages;
+            signedMessages.reserve(messages.size());
+            for (size_t i = 0; i < messages.size(); ++i) {
+                BigInt s = r[i] * privateKey;
+                s += m[i];
+                s.mulModInPlace(inverseK[i], n, ctx);
+                if (s == 0) {
+                    signedMessages.push_back(this->sign(messages[i], privateKey));
+                    continue;
+                }
+                signedMessages.push_back(SignedMessage(messages[i], Signature(move(r[i]), move(s))));
+            }
+            return signedMessages;
+        }
+
+        virtual bool verify(
+            span<const Byte> message,
+            const Signature& signature,
+            const PublicKey& publicKey
+        ) const override {
+            const Arena::Scope scope;
+            const BigInt::Context ctx;
+            const BigInt& n = this->context->getBasePointOrder();
+            if (!isInRange(signature, n)) {
                 return false;
             }
-            const BigInt v = BigInt::mod(Q.getX(), n);
-            return v == r;
+            const BigInt inverseS = BigInt::computeInverseModulo(signature.getS(), n, ctx);
+            return this->verify(message, signature, publicKey, inverseS, ctx);
+        }
+
+        /**
+         * Verifies signedMessages[i] against publicKeys[i] for every i.
+         * The batch is split into shards that run on the thread pool,
+         * every shard inverts all of its s values with a single modular
+         * inversion.
+         */
+        vector<bool> verifyBatch(
+            span<const SignedMessage<OctetString>> signedMessages,
+            span<const PublicKey> publicKeys,
+            ThreadPool& threadPool = ThreadPool::getShared()
+        ) const {
+            if (signedMessages.size() != publicKeys.size()) {
+                throw invalid_argument(
+                    "The 'signedMessages' and 'publicKeys' parameters must be "
+                    "of equal size"
+                );
+            }
+            vector<char> results(signedMessages.size(), false);
+            threadPool.forEachShard(
+                signedMessages.size(),
+                VERIFY_BATCH_SHARD_SIZE,
+                [&](const size_t begin, const size_t end) {
+                    const Arena::Scope scope;
+                    const BigInt::Context ctx;
+                    const BigInt& n = this->context->getBasePointOrder();
+                    vector<size_t> indices;
+                    vector<BigInt> s;
+                    for (size_t i = begin; i < end; ++i) {
+                        const Signature& signature = signedMessages[i].getSignature();
+                        if (isInRange(signature, n)) {
+                            indices.push_back(i);
+                            s.push_back(signature.getS());
+                        }
+                    }
+                    const vector<BigInt> inverseS = BigInt::batchInverseModulo(s, n, ctx);
+                    for (size_t j = 0; j < indices.size(); ++j) {
+                        const size_t i = indices[j];
+                        results[i] = this->verify(
+                            span<const Byte>(signedMessages[i].getMessage()),
+                            signedMessages[i].getSignature(),
+                            publicKeys[i],
+                            inverseS[j],
+                            ctx
+                        );
+                    }
+                }
+            );
+            return vector<bool>(results.begin(), results.end());
         }
     };
 }
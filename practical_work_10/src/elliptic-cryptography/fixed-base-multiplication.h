@@ -0,0 +1,215 @@
+#ifndef FIXED_BASE_MULTIPLICATION_H_INCLUDED
+#define FIXED_BASE_MULTIPLICATION_H_INCLUDED
+
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include <openssl/bn.h>
+#include <openssl/ec.h>
+#include "../definitions.h"
+#include "../big-int.h"
+#include "group.h"
+#include "point.h"
+#include "secp256k1/engine.h"
+
+using namespace std;
+
+namespace EllipticCryptography {
+    const size_t DEFAULT_FIXED_BASE_WINDOW_WIDTH = 4;
+    const size_t MAX_FIXED_BASE_WINDOW_WIDTH = 8;
+    /**
+     * Rough heap size of an EC_POINT besides its three coordinates.
+     */
+    const size_t EC_POINT_OVERHEAD_SIZE = 128;
+
+    /**
+     * Windowed table of multiples of a fixed point.
+     * For a window width w the table holds d * 2^(w * j) * base for every
+     * nonzero w-bit digit d and every window j of the scalar, so a
+     * multiple costs one point addition per nonzero window and no
+     * doublings. The entries are kept in affine form, which lets every
+     * addition use the cheaper mixed formulas.
+     * Unlike EC_POINT_mul, the running time depends on the scalar, so
+     * the table is only meant for public scalars such as those of
+     * signature verification, never for nonces or private keys.
+     * Scalars are expected to be below the order of the base point,
+     * the table takes (2^w - 1) * ceil(log2(order) / w) points,
+     * a wider window trades memory for fewer additions.
+     * On secp256k1 the table is kept in the native engine's format.
+     */
+    class FixedBaseMultiplication {
+    private:
+        Point base;
+        size_t windowWidth;
+        size_t maxScalarLength;
+        size_t rowLength;
+        vector<Point> table;
+        vector<Secp256k1::AffinePoint> nativeTable;
+
+        friend class CurveContext;
+
+    private:
+        /**
+         * Passes through a width in [1, MAX_FIXED_BASE_WINDOW_WIDTH].
+         */
+        static size_t validateWindowWidth(const size_t windowWidth) {
+            if (windowWidth == 0 || windowWidth > MAX_FIXED_BASE_WINDOW_WIDTH) {
+                throw invalid_argument(
+                    "The 'windowWidth' parameter cannot be equal to "
+                    + to_string(windowWidth)
+                );
+            }
+            return windowWidth;
+        }
+
+        static size_t getPointSize(const size_t maxScalarLength) {
+            return sizeof(Point) + EC_POINT_OVERHEAD_SIZE
+                + 3 * ((maxScalarLength + 7) / 8);
+        }
+
+    public:
+        FixedBaseMultiplication(
+            const Point& base,
+            const BigInt& order,
+            const size_t windowWidth = DEFAULT_FIXED_BASE_WINDOW_WIDTH
+        )
+        :   base(base),
+            windowWidth(validateWindowWidth(windowWidth)),
+            maxScalarLength(order.getNumberOfBits()),
+            rowLength((size_t(1) << this->windowWidth) - 1)
+        {
+            const EC_GROUP* group = base.group->get();
+            const BigInt::Context ctx;
+            if (Secp256k1::Engine::isSupported(group)) {
+                this->nativeTable = Secp256k1::Engine::computeTable(
+                    group, base.data, windowWidth, ctx
+                );
+                return;
+            }
+            const size_t numberOfRows =
+                (this->maxScalarLength + windowWidth - 1) / windowWidth;
+            this->table.reserve(numberOfRows * this->rowLength);
+
+            Point rowBase = base;
+            for (size_t row = 0; row < numberOfRows; ++row) {
+                const size_t first = this->table.size();
+                this->table.push_back(rowBase);
+                for (size_t d = 1; d < this->rowLength; ++d) {
+                    Point entry(base.group);
+                    if (!EC_POINT_add(
+                        group,
+                        entry.data,
+                        this->table[first + d - 1].data,
+                        rowBase.data,
+                        ctx.data
+                    )) {
+                        throw runtime_error(OPERATION_FAILED);
+                    }
+                    this->table.push_back(move(entry));
+                }
+                if (!EC_POINT_add(
+                    group,
+                    rowBase.data,
+                    this->table.back().data,
+                    rowBase.data,
+                    ctx.data
+                )) {
+                    throw runtime_error(OPERATION_FAILED);
+                }
+                rowBase.affine = false;
+            }
+
+            Point::normalizeBatch(this->table, ctx);
+        }
+
+        const Point& getBase() const {
+            return this->base;
+        }
+
+        size_t getWindowWidth() const {
+            return this->windowWidth;
+        }
+
+        /**
+         * Approximate number of bytes taken by the table.
+         */
+        size_t getMemoryUsage() const {
+            return sizeof(*this)
+                + this->table.capacity() * getPointSize(this->maxScalarLength)
+                + this->nativeTable.capacity() * sizeof(Secp256k1::AffinePoint);
+        }
+
+        /**
+         * The value getMemoryUsage() would return for a table of the
+         * point, computed without building the table.
+         */
+        static size_t estimateMemoryUsage(
+            const Point& base,
+            const BigInt& order,
+            const size_t windowWidth = DEFAULT_FIXED_BASE_WINDOW_WIDTH
+        ) {
+            const size_t rowLength =
+                (size_t(1) << validateWindowWidth(windowWidth)) - 1;
+            if (Secp256k1::Engine::isSupported(base.group->get())) {
+                const size_t numberOfRows =
+                    (Secp256k1::FIELD_ELEMENT_SIZE * BITS_PER_BYTE + windowWidth - 1)
+                    / windowWidth;
+                return sizeof(FixedBaseMultiplication)
+                    + numberOfRows * rowLength * sizeof(Secp256k1::AffinePoint);
+            }
+            const size_t maxScalarLength = order.getNumberOfBits();
+            const size_t numberOfRows = (maxScalarLength + windowWidth - 1) / windowWidth;
+            return sizeof(FixedBaseMultiplication)
+                + numberOfRows * rowLength * getPointSize(maxScalarLength);
+        }
+
+        Point multiply(
+            const BigInt& n, const BigInt::Context& ctx = BigInt::Context()
+        ) const {
+            if (!this->nativeTable.empty()) {
+                Point result(this->base.group);
+                Secp256k1::Engine::multiply(
+                    this->base.group->get(),
+                    result.data,
+                    this->nativeTable,
+                    this->windowWidth,
+                    n,
+                    ctx
+                );
+                result.markAffine();
+                return result;
+            }
+            const BigInt::Context::Frame frame(ctx);
+            const BIGNUM* scalar = n.input(ctx);
+            const size_t numberOfBits = BN_num_bits(scalar);
+            if (BN_is_negative(scalar) || numberOfBits > this->maxScalarLength) {
+                return this->base * n;
+            }
+
+            const EC_GROUP* group = this->base.group->get();
+            Point result(this->base.group);
+            for (
+                size_t bit = 0, row = 0;
+                bit < numberOfBits;
+                bit += this->windowWidth, ++row
+            ) {
+                size_t digit = 0;
+                for (size_t i = this->windowWidth; i-- > 0;) {
+                    digit = (digit << 1) | BN_is_bit_set(scalar, bit + i);
+                }
+                if (digit && !EC_POINT_add(
+                    group,
+                    result.data,
+                    result.data,
+                    this->table[row * this->rowLength + digit - 1].data,
+                    ctx.data
+                )) {
+                    throw runtime_error(OPERATION_FAILED);
+                }
+            }
+            return result;
+        }
+    };
+}
+
+#endif // FIXED_BASE_MULTIPLICATION_H_INCLUDED
@@ -0,0 +1,89 @@
+#ifndef GROUP_H_INCLUDED
+#define GROUP_H_INCLUDED
+
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+#include <openssl/ec.h>
+#include "../definitions.h"
+#include "shared.h"
+
+using namespace std;
+
+namespace EllipticCryptography {
+    /**
+     * Immutable EC_GROUP shared by a curve and all of its points.
+     * Groups are interned: equal groups are represented by one handle,
+     * so checking that two points belong to the same curve is a pointer
+     * comparison and copying a point never duplicates its group.
+     */
+    class Group {
+    private:
+        EC_GROUP* data = nullptr;
+
+    private:
+        inline static mutex registryMutex;
+        inline static vector<weak_ptr<const Group>> registry;
+
+    private:
+        Group(EC_GROUP* data) : data(data) {}
+
+    public:
+        Group(const Group& other) = delete;
+
+        ~Group() {
+            EC_GROUP_free(this->data);
+        }
+
+        Group& operator=(const Group& other) = delete;
+
+        const EC_GROUP* get() const {
+            return this->data;
+        }
+
+        /**
+         * Returns the handle of a group equal to the given one, taking
+         * ownership of the argument.
+         */
+        static shared_ptr<const Group> intern(EC_GROUP* group) {
+            if (!group) {
+                throw runtime_error(OPERATION_FAILED);
+            }
+
+            const lock_guard<mutex> lock(registryMutex);
+            shared_ptr<const Group> result;
+            auto it = registry.begin();
+            while (it != registry.end()) {
+                shared_ptr<const Group> existing = it->lock();
+                if (!existing) {
+                    it = registry.erase(it);
+                    continue;
+                }
+                if (!result && areEqual(existing->data, group)) {
+                    result = existing;
+                }
+                ++it;
+            }
+
+            if (result) {
+                EC_GROUP_free(group);
+                return result;
+            }
+            try {
+                result = shared_ptr<const Group>(new Group(group));
+            } catch (...) {
+                EC_GROUP_free(group);
+                throw;
+            }
+            registry.push_back(result);
+            return result;
+        }
+
+        static shared_ptr<const Group> intern(const EC_GROUP* group) {
+            return intern(EC_GROUP_dup(group));
+        }
+    };
+}
+
+#endif // GROUP_H_INCLUDED
@@ -0,0 +1,154 @@
+#ifndef HASH_FUNCTION_H_INCLUDED
+#define HASH_FUNCTION_H_INCLUDED
+
+#include <array>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <openssl/evp.h>
+#include "../definitions.h"
+
+using namespace std;
+
+namespace EllipticCryptography {
+    const size_t MAX_DIGEST_SIZE = EVP_MAX_MD_SIZE;
+
+    using Digest = array<Byte, MAX_DIGEST_SIZE>;
+
+    enum class HashAlgorithm {
+        SHA1,
+        SHA256,
+        SHA512,
+    };
+
+    /**
+     * Hash function that takes its input in pieces. An instance hashes
+     * one message at a time, createInstance() gives an independent one,
+     * e.g. for another thread.
+     */
+    class HashFunction {
+    public:
+        virtual ~HashFunction() = default;
+
+        virtual size_t getDigestSize() const = 0;
+
+        virtual void update(span<const Byte> data) = 0;
+
+        /**
+         * Writes the digest of everything passed to update() to the start
+         * of the buffer and starts over with an empty message.
+         */
+        virtual void finalize(span<Byte> digest) = 0;
+
+        virtual unique_ptr<HashFunction> createInstance() const = 0;
+    };
+
+    /**
+     * HashFunction backed by an EVP_MD_CTX. The digest implementations are
+     * fetched once per process, so starting a message takes no lookup.
+     */
+    class EvpHashFunction : public HashFunction {
+    private:
+        /**
+         * Digest implementation fetched once per process.
+         */
+        struct Method {
+            EVP_MD* data;
+
+            Method(const char* name) : data(EVP_MD_fetch(nullptr, name, nullptr)) {
+                if (!this->data) {
+                    throw runtime_error(OPERATION_FAILED);
+                }
+            }
+
+            ~Method() {
+                EVP_MD_free(this->data);
+            }
+        };
+
+        HashAlgorithm algorithm;
+        const EVP_MD* method;
+        EVP_MD_CTX* data = nullptr;
+
+    public:
+        /**
+         * Returns the digest implementation of the algorithm, fetched on
+         * the first call.
+         */
+        static const EVP_MD* getMethod(const HashAlgorithm algorithm) {
+            switch (algorithm) {
+                case HashAlgorithm::SHA1: {
+                    static const Method method("SHA1");
+                    return method.data;
+                }
+                case HashAlgorithm::SHA256: {
+                    static const Method method("SHA256");
+                    return method.data;
+                }
+                case HashAlgorithm::SHA512: {
+                    static const Method method("SHA512");
+                    return method.data;
+                }
+            }
+            throw invalid_argument(
+                "The 'algorithm' parameter cannot be equal to "
+                + to_string(static_cast<int>(algorithm))
+            );
+        }
+
+        EvpHashFunction(const HashAlgorithm algorithm = HashAlgorithm::SHA1)
+        :   algorithm(algorithm),
+            method(getMethod(algorithm)),
+            data(EVP_MD_CTX_new())
+        {
+            if (!this->data || !EVP_DigestInit_ex(this->data, this->method, nullptr)) {
+                EVP_MD_CTX_free(this->data);
+                throw runtime_error(OPERATION_FAILED);
+            }
+        }
+
+        EvpHashFunction(const EvpHashFunction& other) = delete;
+
+        ~EvpHashFunction() {
+            EVP_MD_CTX_free(this->data);
+        }
+
+        EvpHashFunction& operator=(const EvpHashFunction& other) = delete;
+
+        HashAlgorithm getAlgorithm() const {
+            return this->algorithm;
+        }
+
+        virtual size_t getDigestSize() const override {
+            return EVP_MD_get_size(this->method);
+        }
+
+        virtual void update(span<const Byte> data) override {
+            if (!EVP_DigestUpdate(this->data, data.data(), data.size())) {
+                throw runtime_error(OPERATION_FAILED);
+            }
+        }
+
+        virtual void finalize(span<Byte> digest) override {
+            const size_t size = this->getDigestSize();
+            if (digest.size() < size) {
+                throw invalid_argument(
+                    "The 'digest' parameter must hold at least "
+                    + to_string(size) + " bytes"
+                );
+            }
+            if (
+                !EVP_DigestFinal_ex(this->data, digest.data(), nullptr)
+                || !EVP_DigestInit_ex(this->data, this->method, nullptr)
+            ) {
+                throw runtime_error(OPERATION_FAILED);
+            }
+        }
+
+        virtual unique_ptr<HashFunction> createInstance() const override {
+            return make_unique<EvpHashFunction>(this->algorithm);
+        }
+    };
+}
+
+#endif // HASH_FUNCTION_H_INCLUDED
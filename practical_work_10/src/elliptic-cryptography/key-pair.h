@@ -2,6 +2,7 @@
 #define KEY_PAIR_H_INCLUDED
 
 #include <ostream>
+#include <vector>
 #include "curve.h"
 #include "point.h"
 
@@ -34,9 +35,34 @@ namespace EllipticCryptography {
             const PrivateKey privateKey = BigInt::generateInRange(
                 1, curve.getBasePointOrder() - 1
             );
-            const PublicKey publicKey = privateKey * curve.getBasePoint();
+            const PublicKey publicKey = curve.multiplyBasePoint(privateKey);
             return KeyPair(privateKey, publicKey);
         }
+
+        /**
+         * Generates many key pairs, bringing all the public keys to affine
+         * form with a single field inversion.
+         */
+        static vector<KeyPair> generateBatch(const Curve& curve, const size_t count) {
+            const BigInt::Context ctx;
+            vector<PrivateKey> privateKeys;
+            vector<PublicKey> publicKeys;
+            privateKeys.reserve(count);
+            publicKeys.reserve(count);
+            for (size_t i = 0; i < count; ++i) {
+                privateKeys.push_back(BigInt::generateInRange(
+                    1, curve.getBasePointOrder() - 1
+                ));
+                publicKeys.push_back(curve.multiplyBasePoint(privateKeys.back(), ctx));
+            }
+            Point::normalizeBatch(publicKeys, ctx);
+            vector<KeyPair> keyPairs;
+            keyPairs.reserve(count);
+            for (size_t i = 0; i < count; ++i) {
+                keyPairs.push_back(KeyPair(privateKeys[i], publicKeys[i]));
+            }
+            return keyPairs;
+        }
     };
 
     ostream& operator<<(ostream& out, const KeyPair& keyPair) {
@@ -0,0 +1,202 @@
+#ifndef NONCE_GENERATOR_H_INCLUDED
+#define NONCE_GENERATOR_H_INCLUDED
+
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <openssl/core_names.h>
+#include <openssl/evp.h>
+#include <openssl/params.h>
+#include "../definitions.h"
+#include "../big-int.h"
+#include "hash-function.h"
+
+using namespace std;
+
+namespace EllipticCryptography {
+    enum class NonceGeneration {
+        /**
+         * Nonces are drawn from OpenSSL's random generator.
+         */
+        RANDOM,
+        /**
+         * Nonces are derived from the private key and the message hash as
+         * in RFC 6979, with an HMAC_DRBG over the hash of the messages.
+         */
+        DETERMINISTIC,
+    };
+
+    /**
+     * Nonces k in [1, n - 1] for the signatures of one message.
+     * The deterministic mode follows section 3.2 of RFC 6979: the same key
+     * and message always give the same sequence, and no global random
+     * generator is touched, so threads that sign at once do not contend.
+     */
+    class NonceGenerator {
+    private:
+        /**
+         * HMAC implementation fetched once per process.
+         */
+        struct Mac {
+            EVP_MAC* data;
+
+            Mac() : data(EVP_MAC_fetch(nullptr, OSSL_MAC_NAME_HMAC, nullptr)) {
+                if (!this->data) {
+                    throw runtime_error(OPERATION_FAILED);
+                }
+            }
+
+            ~Mac() {
+                EVP_MAC_free(this->data);
+            }
+        };
+
+        NonceGeneration mode;
+        BigInt order;
+        size_t orderLength;
+        EVP_MAC_CTX* mac = nullptr;
+        size_t macLength = 0;
+        OctetString K;
+        OctetString V;
+        bool isFirst = true;
+
+        static EVP_MAC* getMac() {
+            static const Mac mac;
+            return mac.data;
+        }
+
+        /**
+         * Sets K = HMAC_K(V || separator || data), V = HMAC_K(V).
+         */
+        void update(const Byte separator, span<const Byte> data) {
+            this->K = this->computeMac(this->V, span(&separator, 1), data);
+            this->V = this->computeMac(this->V);
+        }
+
+        OctetString computeMac(
+            span<const Byte> first,
+            span<const Byte> second = {},
+            span<const Byte> third = {}
+        ) const {
+            OctetString result(this->macLength);
+            size_t length = 0;
+            if (
+                !EVP_MAC_init(this->mac, this->K.data(), this->K.size(), nullptr)
+                || !EVP_MAC_update(this->mac, first.data(), first.size())
+                || !EVP_MAC_update(this->mac, second.data(), second.size())
+                || !EVP_MAC_update(this->mac, third.data(), third.size())
+                || !EVP_MAC_final(this->mac, result.data(), &length, result.size())
+                || length != result.size()
+            ) {
+                throw runtime_error(OPERATION_FAILED);
+            }
+            return result;
+        }
+
+    public:
+        /**
+         * The digest is the hash of the message the signature covers,
+         * computed with the given algorithm, which the HMAC also uses.
+         */
+        NonceGenerator(
+            const NonceGeneration mode,
+            const BigInt& privateKey,
+            span<const Byte> digest,
+            const BigInt& order,
+            const HashAlgorithm hashAlgorithm
+        )
+        :   mode(mode),
+            order(order),
+            orderLength(
+                (order.getNumberOfBits() + BITS_PER_BYTE - 1) / BITS_PER_BYTE
+            )
+        {
+            if (mode != NonceGeneration::DETERMINISTIC) {
+                return;
+            }
+            const EVP_MD* method = EvpHashFunction::getMethod(hashAlgorithm);
+            this->macLength = EVP_MD_get_size(method);
+            this->mac = EVP_MAC_CTX_new(getMac());
+            const OSSL_PARAM parameters[] = {
+                OSSL_PARAM_construct_utf8_string(
+                    OSSL_MAC_PARAM_DIGEST,
+                    const_cast<char*>(EVP_MD_get0_name(method)),
+                    0
+                ),
+                OSSL_PARAM_construct_end(),
+            };
+            if (!this->mac || !EVP_MAC_CTX_set_params(this->mac, parameters)) {
+                EVP_MAC_CTX_free(this->mac);
+                throw runtime_error(OPERATION_FAILED);
+            }
+
+            BigInt h = BigInt::fromOctetString(
+                digest, this->order.getNumberOfBits()
+            );
+            if (!(h < order)) {
+                h -= order;
+            }
+            OctetString seed = privateKey.toOctetString(this->orderLength);
+            const OctetString hash = h.toOctetString(this->orderLength);
+            seed.insert(seed.end(), hash.begin(), hash.end());
+            this->K.assign(this->macLength, 0x00);
+            this->V.assign(this->macLength, 0x01);
+            this->update(0x00, seed);
+            this->update(0x01, seed);
+            OPENSSL_cleanse(seed.data(), seed.size());
+        }
+
+        NonceGenerator(const NonceGenerator& other) = delete;
+
+        NonceGenerator(NonceGenerator&& other) noexcept
+        :   mode(other.mode),
+            order(move(other.order)),
+            orderLength(other.orderLength),
+            mac(exchange(other.mac, nullptr)),
+            macLength(other.macLength),
+            K(move(other.K)),
+            V(move(other.V)),
+            isFirst(other.isFirst)
+        {}
+
+        ~NonceGenerator() {
+            EVP_MAC_CTX_free(this->mac);
+            OPENSSL_cleanse(this->K.data(), this->K.size());
+            OPENSSL_cleanse(this->V.data(), this->V.size());
+        }
+
+        NonceGenerator& operator=(const NonceGenerator& other) = delete;
+
+        NonceGenerator& operator=(NonceGenerator&& other) = delete;
+
+        /**
+         * Returns the next nonce. A signature that turns out unusable with
+         * a nonce asks for another one.
+         */
+        BigInt next() {
+            if (this->mode != NonceGeneration::DETERMINISTIC) {
+                return BigInt::generateInRange(1, this->order - 1);
+            }
+            if (!this->isFirst) {
+                this->update(0x00, {});
+            }
+            this->isFirst = false;
+            while (true) {
+                OctetString T;
+                while (T.size() < this->orderLength) {
+                    this->V = this->computeMac(this->V);
+                    T.insert(T.end(), this->V.begin(), this->V.end());
+                }
+                const BigInt k = BigInt::fromOctetString(
+                    T, this->order.getNumberOfBits()
+                );
+                if (k > 0 && k < this->order) {
+                    return k;
+                }
+                this->update(0x00, {});
+            }
+        }
+    };
+}
+
+#endif // NONCE_GENERATOR_H_INCLUDED
@@ -1,12 +1,20 @@
 #ifndef POINT_H_INCLUDED
 #define POINT_H_INCLUDED
 
+#include <algorithm>
+#include <limits>
+#include <memory>
 #include <ostream>
+#include <span>
+#include <utility>
 #include <stdexcept>
+#include <vector>
 #include <openssl/ec.h>
 #include "../definitions.h"
 #include "../big-int.h"
-#include "shared.h"
+#include "../thread-pool.h"
+#include "group.h"
+#include "secp256k1/engine.h"
 
 struct Vector2 {
 public:
@@ -26,65 +34,200 @@ ostream& operator<<(ostream& out, const Vector2& vec) {
 }
 
 namespace EllipticCryptography {
+    /**
+     * SEC1 point encodings: 0x02 or 0x03 (the parity of y) followed by x,
+     * or 0x04 followed by x and y.
+     */
+    enum class PointEncoding {
+        COMPRESSED = POINT_CONVERSION_COMPRESSED,
+        UNCOMPRESSED = POINT_CONVERSION_UNCOMPRESSED,
+    };
+
+    const size_t LINEAR_COMBINATION_WINDOW_WIDTH = 4;
+    const size_t MAX_BUCKET_WINDOW_WIDTH = 16;
+
     class Point {
     private:
         friend class Curve;
+        friend class CurveContext;
+        friend class FixedBaseMultiplication;
+        friend class PublicKeyCache;
         friend ostream& operator<<(
             ostream& out, const EllipticCryptography::Point& point
         );
 
     private:
         EC_POINT* data = nullptr;
-        EC_GROUP* group = nullptr;
+        shared_ptr<const Group> group;
+        /**
+         * Whether the point is known to have Z = 1 in OpenSSL's Jacobian
+         * representation, so reading its coordinates needs no inversion.
+         */
+        bool affine = false;
 
-    public:
-        Point(const EC_GROUP* group)
-        :   data(EC_POINT_new(group)),
-            group(EC_GROUP_dup(group))
+    private:
+        Point(shared_ptr<const Group> group)
+        :   data(EC_POINT_new(group->get())),
+            group(move(group))
         {
             if (!this->data) {
                 throw runtime_error(OPERATION_FAILED);
             }
         }
 
-        Point(const EC_POINT* data, const EC_GROUP* group)
-        :   data(EC_POINT_dup(data, group)),
-            group(EC_GROUP_dup(group))
+        Point(const EC_POINT* data, shared_ptr<const Group> group)
+        :   data(EC_POINT_dup(data, group->get())),
+            group(move(group))
         {
             if (!this->data) {
                 throw runtime_error(OPERATION_FAILED);
             }
         }
 
-        Point(const Point& other) : Point(other.data, other.group) {}
+        void markAffine() {
+            this->affine = !this->isAtInfinity();
+        }
+
+    public:
+        Point(const Point& other) : Point(other.data, other.group) {
+            this->affine = other.affine;
+        }
+
+        Point(Point&& other) noexcept
+        :   data(other.data),
+            group(move(other.group)),
+            affine(other.affine)
+        {
+            other.data = nullptr;
+        }
 
         ~Point() {
             EC_POINT_clear_free(this->data);
-            EC_GROUP_free(this->group);
         }
 
-        Vector2 getCoordinates() const {
+        Vector2 getCoordinates(
+            const BigInt::Context& ctx = BigInt::Context()
+        ) const {
             Vector2 coordinates;
             if (!EC_POINT_get_affine_coordinates(
-                this->group,
+                this->group->get(),
                 this->data,
-                coordinates.x.data,
-                coordinates.y.data,
-                BigInt::Context().data
+                coordinates.x.output(),
+                coordinates.y.output(),
+                ctx.data
             )) {
                 throw runtime_error(OPERATION_FAILED);
             }
             return coordinates;
         }
 
-        BigInt getX() const {
-            return this->getCoordinates().x;
+        BigInt getX(const BigInt::Context& ctx = BigInt::Context()) const {
+            return this->getCoordinates(ctx).x;
+        }
+
+        /**
+         * Returns the length of the SEC1 encoding, which is a single zero
+         * byte for the point at infinity.
+         */
+        size_t getEncodedSize(
+            const PointEncoding encoding = PointEncoding::COMPRESSED,
+            const BigInt::Context& ctx = BigInt::Context()
+        ) const {
+            const size_t size = EC_POINT_point2oct(
+                this->group->get(),
+                this->data,
+                static_cast<point_conversion_form_t>(encoding),
+                nullptr,
+                0,
+                ctx.data
+            );
+            if (!size) {
+                throw runtime_error(OPERATION_FAILED);
+            }
+            return size;
+        }
+
+        /**
+         * Writes the SEC1 encoding to the start of the buffer and returns
+         * its length.
+         */
+        size_t encode(
+            span<Byte> buffer,
+            const PointEncoding encoding = PointEncoding::COMPRESSED,
+            const BigInt::Context& ctx = BigInt::Context()
+        ) const {
+            const size_t size = this->getEncodedSize(encoding, ctx);
+            if (buffer.size() < size) {
+                throw invalid_argument(
+                    "The 'buffer' parameter must hold at least "
+                    + to_string(size) + " bytes"
+                );
+            }
+            if (EC_POINT_point2oct(
+                this->group->get(),
+                this->data,
+                static_cast<point_conversion_form_t>(encoding),
+                buffer.data(),
+                size,
+                ctx.data
+            ) != size) {
+                throw runtime_error(OPERATION_FAILED);
+            }
+            return size;
+        }
+
+        bool isAtInfinity() const {
+            return EC_POINT_is_at_infinity(this->group->get(), this->data);
+        }
+
+        bool isAffine() const {
+            return this->affine;
+        }
+
+        /**
+         * Brings every point to Z = 1 with a single field inversion shared
+         * by the whole batch, after which getCoordinates and additions
+         * with these points are cheap. Points already known to be affine
+         * and the point at infinity are skipped.
+         */
+        static void normalizeBatch(
+            span<Point> points, const BigInt::Context& ctx = BigInt::Context()
+        ) {
+            vector<EC_POINT*> data;
+            data.reserve(points.size());
+            for (const Point& point : points) {
+                if (point.group != points[0].group) {
+                    throw runtime_error(OPERATION_FAILED);
+                }
+                if (!point.affine && !point.isAtInfinity()) {
+                    data.push_back(point.data);
+                }
+            }
+            if (data.empty()) {
+                return;
+            }
+            // OpenSSL 3.0 deprecated a few EC calls without replacing
+            // them, and this one is the only public way to share one
+            // inversion across points. The warning is silenced around
+            // each such call.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+            const int result = EC_POINTs_make_affine(
+                points[0].group->get(), data.size(), data.data(), ctx.data
+            );
+#pragma GCC diagnostic pop
+            if (!result) {
+                throw runtime_error(OPERATION_FAILED);
+            }
+            for (Point& point : points) {
+                point.markAffine();
+            }
         }
 
-        Point doubled() const {
+        Point doubled(const BigInt::Context& ctx = BigInt::Context()) const {
             Point result(this->group);
             if (!EC_POINT_dbl(
-                this->group, result.data, this->data, BigInt::Context().data
+                this->group->get(), result.data, this->data, ctx.data
             )) {
                 throw runtime_error(OPERATION_FAILED);
             }
@@ -93,24 +236,30 @@ namespace EllipticCryptography {
 
         Point& operator=(const Point& other) {
             if (this != &other) {
-                if (
-                    !EC_POINT_copy(this->data, other.data)
-                    ||
-                    !EC_GROUP_copy(this->group, other.group)
-                ) {
+                if (this->group != other.group) {
+                    *this = Point(other);
+                } else if (!EC_POINT_copy(this->data, other.data)) {
                     throw runtime_error(OPERATION_FAILED);
                 }
+                this->affine = other.affine;
             }
             return *this;
         }
 
+        Point& operator=(Point&& other) noexcept {
+            swap(this->data, other.data);
+            swap(this->group, other.group);
+            swap(this->affine, other.affine);
+            return *this;
+        }
+
         Point operator+(const Point& other) const {
             Point result(this->group);
             if (
-                !areEqual(this->group, other.group)
+                this->group != other.group
                 ||
                 !EC_POINT_add(
-                    this->group,
+                    this->group->get(),
                     result.data,
                     this->data,
                     other.data,
@@ -121,32 +270,298 @@ namespace EllipticCryptography {
             return result;
         }
 
+        /**
+         * The scalar may be secret, as in Diffie-Hellman: both the native
+         * engine on secp256k1 and EC_POINT_mul run in time independent of
+         * it.
+         */
         Point operator*(const BigInt& n) const {
             Point result(this->group);
+            const BigInt::Context ctx;
+            if (Secp256k1::Engine::isSupported(this->group->get())) {
+                Secp256k1::Engine::multiply(
+                    this->group->get(), result.data, this->data, n, ctx
+                );
+                result.markAffine();
+                return result;
+            }
+            const BigInt::Context::Frame frame(ctx);
             if (!EC_POINT_mul(
-                this->group,
+                this->group->get(),
                 result.data,
                 nullptr,
                 this->data,
-                n.data,
-                BigInt::Context().data
+                n.input(ctx),
+                ctx.data
             )) {
                 throw runtime_error(OPERATION_FAILED);
             }
             return result;
         }
 
+        /**
+         * Computes the sum of scalars[i] * points[i] with Straus'
+         * interleaving: the terms share one chain of doublings, and each
+         * term only adds a precomputed multiple of its point per window.
+         * On secp256k1 the sum is evaluated by the native engine.
+         */
+        static Point linearCombination(
+            span<const BigInt> scalars,
+            span<const Point> points,
+            const BigInt::Context& ctx = BigInt::Context()
+        ) {
+            if (points.empty() || scalars.size() != points.size()) {
+                throw invalid_argument(
+                    "The 'scalars' and 'points' parameters must be nonempty "
+                    "and of equal size"
+                );
+            }
+            const shared_ptr<const Group>& group = points[0].group;
+            if (Secp256k1::Engine::isSupported(group->get())) {
+                vector<const EC_POINT*> data(points.size());
+                for (size_t i = 0; i < points.size(); ++i) {
+                    if (points[i].group != group) {
+                        throw runtime_error(OPERATION_FAILED);
+                    }
+                    data[i] = points[i].data;
+                }
+                Point result(group);
+                Secp256k1::Engine::linearCombination(
+                    group->get(), result.data, scalars, data, ctx
+                );
+                result.markAffine();
+                return result;
+            }
+            const BigInt::Context::Frame frame(ctx);
+            const size_t rowLength =
+                (size_t(1) << LINEAR_COMBINATION_WINDOW_WIDTH) - 1;
+
+            vector<const BIGNUM*> k(scalars.size());
+            vector<Point> table;
+            table.reserve(points.size() * rowLength);
+            size_t maxNumberOfBits = 0;
+            for (size_t i = 0; i < points.size(); ++i) {
+                if (points[i].group != group) {
+                    throw runtime_error(OPERATION_FAILED);
+                }
+                k[i] = scalars[i].input(ctx);
+                maxNumberOfBits =
+                    max<size_t>(maxNumberOfBits, BN_num_bits(k[i]));
+                table.push_back(points[i]);
+                if (
+                    BN_is_negative(k[i])
+                    && !EC_POINT_invert(
+                        group->get(), table.back().data, ctx.data
+                    )
+                ) {
+                    throw runtime_error(OPERATION_FAILED);
+                }
+                const Point& first = table.back();
+                for (size_t d = 1; d < rowLength; ++d) {
+                    Point entry(group);
+                    if (!EC_POINT_add(
+                        group->get(),
+                        entry.data,
+                        table.back().data,
+                        first.data,
+                        ctx.data
+                    )) {
+                        throw runtime_error(OPERATION_FAILED);
+                    }
+                    table.push_back(move(entry));
+                }
+            }
+
+            normalizeBatch(table, ctx);
+
+            Point result(group);
+            const size_t numberOfWindows =
+                (maxNumberOfBits + LINEAR_COMBINATION_WINDOW_WIDTH - 1)
+                / LINEAR_COMBINATION_WINDOW_WIDTH;
+            for (size_t window = numberOfWindows; window-- > 0;) {
+                for (size_t i = 0; i < LINEAR_COMBINATION_WINDOW_WIDTH; ++i) {
+                    if (!EC_POINT_dbl(
+                        group->get(), result.data, result.data, ctx.data
+                    )) {
+                        throw runtime_error(OPERATION_FAILED);
+                    }
+                }
+                const size_t bit = window * LINEAR_COMBINATION_WINDOW_WIDTH;
+                for (size_t i = 0; i < k.size(); ++i) {
+                    size_t digit = 0;
+                    for (size_t j = LINEAR_COMBINATION_WINDOW_WIDTH; j-- > 0;) {
+                        digit = (digit << 1) | BN_is_bit_set(k[i], bit + j);
+                    }
+                    if (digit && !EC_POINT_add(
+                        group->get(),
+                        result.data,
+                        result.data,
+                        table[i * rowLength + digit - 1].data,
+                        ctx.data
+                    )) {
+                        throw runtime_error(OPERATION_FAILED);
+                    }
+                }
+            }
+            return result;
+        }
+
+        /**
+         * Computes the sum of scalars[i] * points[i] with Pippenger's
+         * bucket method, picking the window width by the number of
+         * points. With a thread pool the windows are summed in parallel.
+         * Prefer it to linearCombination from a few hundred points on.
+         */
+        static Point multiScalarMultiply(
+            span<const BigInt> scalars,
+            span<const Point> points,
+            ThreadPool* threadPool = nullptr,
+            const BigInt::Context& ctx = BigInt::Context()
+        ) {
+            if (points.empty() || scalars.size() != points.size()) {
+                throw invalid_argument(
+                    "The 'scalars' and 'points' parameters must be nonempty "
+                    "and of equal size"
+                );
+            }
+            const shared_ptr<const Group>& group = points[0].group;
+            for (const Point& point : points) {
+                if (point.group != group) {
+                    throw runtime_error(OPERATION_FAILED);
+                }
+            }
+            Point result(group);
+            if (Secp256k1::Engine::isSupported(group->get())) {
+                vector<const EC_POINT*> data(points.size());
+                for (size_t i = 0; i < points.size(); ++i) {
+                    data[i] = points[i].data;
+                }
+                Secp256k1::Engine::multiScalarMultiply(
+                    group->get(), result.data, scalars, data, threadPool, ctx
+                );
+                result.markAffine();
+                return result;
+            }
+
+            const BigInt::Context::Frame frame(ctx);
+            vector<const BIGNUM*> k(scalars.size());
+            vector<Point> bases(points.begin(), points.end());
+            size_t numberOfBits = 0;
+            for (size_t i = 0; i < points.size(); ++i) {
+                k[i] = scalars[i].input(ctx);
+                numberOfBits = max<size_t>(numberOfBits, BN_num_bits(k[i]));
+                if (
+                    BN_is_negative(k[i])
+                    && !EC_POINT_invert(group->get(), bases[i].data, ctx.data)
+                ) {
+                    throw runtime_error(OPERATION_FAILED);
+                }
+            }
+
+            normalizeBatch(bases, ctx);
+
+            size_t windowWidth = 1;
+            size_t bestCost = numeric_limits<size_t>::max();
+            for (size_t c = 1; c <= MAX_BUCKET_WINDOW_WIDTH; ++c) {
+                const size_t cost =
+                    (numberOfBits + c - 1) / c * (points.size() + (size_t(2) << c));
+                if (cost < bestCost) {
+                    windowWidth = c;
+                    bestCost = cost;
+                }
+            }
+            const size_t numberOfWindows =
+                max<size_t>((numberOfBits + windowWidth - 1) / windowWidth, 1);
+
+            vector<Point> windowSums(numberOfWindows, Point(group));
+            const auto sumWindows = [&](const size_t begin, const size_t end) {
+                const BigInt::Context windowCtx;
+                vector<Point> buckets(
+                    (size_t(1) << windowWidth) - 1, Point(group)
+                );
+                for (size_t window = begin; window < end; ++window) {
+                    for (Point& bucket : buckets) {
+                        if (!EC_POINT_set_to_infinity(group->get(), bucket.data)) {
+                            throw runtime_error(OPERATION_FAILED);
+                        }
+                    }
+                    const size_t bit = window * windowWidth;
+                    for (size_t i = 0; i < bases.size(); ++i) {
+                        size_t digit = 0;
+                        for (size_t j = windowWidth; j-- > 0;) {
+                            digit = (digit << 1) | BN_is_bit_set(k[i], bit + j);
+                        }
+                        if (digit && !EC_POINT_add(
+                            group->get(),
+                            buckets[digit - 1].data,
+                            buckets[digit - 1].data,
+                            bases[i].data,
+                            windowCtx.data
+                        )) {
+                            throw runtime_error(OPERATION_FAILED);
+                        }
+                    }
+                    Point runningSum(group);
+                    for (size_t b = buckets.size(); b-- > 0;) {
+                        if (
+                            !EC_POINT_add(
+                                group->get(),
+                                runningSum.data,
+                                runningSum.data,
+                                buckets[b].data,
+                                windowCtx.data
+                            )
+                            || !EC_POINT_add(
+                                group->get(),
+                                windowSums[window].data,
+                                windowSums[window].data,
+                                runningSum.data,
+                                windowCtx.data
+                            )
+                        ) {
+                            throw runtime_error(OPERATION_FAILED);
+                        }
+                    }
+                }
+            };
+            if (threadPool) {
+                threadPool->forEachShard(numberOfWindows, 1, sumWindows);
+            } else {
+                sumWindows(0, numberOfWindows);
+            }
+
+            for (size_t window = numberOfWindows; window-- > 0;) {
+                for (size_t i = 0; i < windowWidth; ++i) {
+                    if (!EC_POINT_dbl(
+                        group->get(), result.data, result.data, ctx.data
+                    )) {
+                        throw runtime_error(OPERATION_FAILED);
+                    }
+                }
+                if (!EC_POINT_add(
+                    group->get(),
+                    result.data,
+                    result.data,
+                    windowSums[window].data,
+                    ctx.data
+                )) {
+                    throw runtime_error(OPERATION_FAILED);
+                }
+            }
+            return result;
+        }
+
         Point& operator*=(const BigInt& n) {
             *this = *this * n;
             return *this;
         }
 
         bool operator==(const Point& other) const {
-            if (!areEqual(this->group, other.group)) {
+            if (this->group != other.group) {
                 throw runtime_error(OPERATION_FAILED);
             }
             const int result = EC_POINT_cmp(
-                this->group, this->data, other.data, BigInt::Context().data
+                this->group->get(), this->data, other.data, BigInt::Context().data
             );
             if (result == -1) {
                 throw runtime_error(OPERATION_FAILED);
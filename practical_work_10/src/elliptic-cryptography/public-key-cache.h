@@ -0,0 +1,185 @@
+#ifndef PUBLIC_KEY_CACHE_H_INCLUDED
+#define PUBLIC_KEY_CACHE_H_INCLUDED
+
+#include <cstring>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include "../definitions.h"
+#include "../big-int.h"
+#include "fixed-base-multiplication.h"
+#include "key-pair.h"
+#include "point.h"
+
+using namespace std;
+
+namespace EllipticCryptography {
+    const size_t DEFAULT_PUBLIC_KEY_CACHE_SIZE = 16 << 20;
+    const size_t PUBLIC_KEY_CACHE_WINDOW_WIDTH = 6;
+
+    /**
+     * Least recently used set of tables of multiples of public keys, so
+     * that verifying many signatures of the same key costs about as much
+     * as a multiplication of the base point. Entries are keyed by the
+     * group and the compressed encoding of the key and are evicted once
+     * the tables exceed the memory budget. Safe to share between threads.
+     * A miss builds a table, which costs about 15 verifications, so the
+     * budget should hold the tables of all the keys that repeat;
+     * FixedBaseMultiplication::estimateMemoryUsage() gives the size of
+     * one. A key whose table alone exceeds the budget is never built.
+     */
+    class PublicKeyCache {
+    public:
+        struct Statistics {
+            size_t hits = 0;
+            size_t misses = 0;
+            size_t evictions = 0;
+            size_t memoryUsage = 0;
+            size_t numberOfEntries = 0;
+        };
+
+    private:
+        using Table = shared_ptr<const FixedBaseMultiplication>;
+        using Entry = pair<string, Table>;
+
+        size_t memoryBudget;
+        size_t windowWidth;
+        mutable mutex cacheMutex;
+        list<Entry> entries;
+        unordered_map<string, list<Entry>::iterator> index;
+        Statistics statistics;
+
+        static string getKey(const PublicKey& publicKey, const BigInt::Context& ctx) {
+            const Group* group = publicKey.group.get();
+            const size_t prefixSize = sizeof(group);
+            string key(
+                prefixSize
+                    + publicKey.getEncodedSize(PointEncoding::COMPRESSED, ctx),
+                '\0'
+            );
+            memcpy(key.data(), &group, prefixSize);
+            const span<Byte> encoding(
+                reinterpret_cast<Byte*>(key.data()) + prefixSize,
+                key.size() - prefixSize
+            );
+            publicKey.encode(encoding, PointEncoding::COMPRESSED, ctx);
+            return key;
+        }
+
+        void evict() {
+            while (
+                this->statistics.memoryUsage > this->memoryBudget
+                && !this->entries.empty()
+            ) {
+                const Entry& last = this->entries.back();
+                this->statistics.memoryUsage -= last.second->getMemoryUsage();
+                this->index.erase(last.first);
+                this->entries.pop_back();
+                ++this->statistics.evictions;
+            }
+        }
+
+    public:
+        PublicKeyCache(
+            const size_t memoryBudget = DEFAULT_PUBLIC_KEY_CACHE_SIZE,
+            const size_t windowWidth = PUBLIC_KEY_CACHE_WINDOW_WIDTH
+        )
+        :   memoryBudget(memoryBudget),
+            windowWidth(windowWidth)
+        {
+            if (windowWidth == 0 || windowWidth > MAX_FIXED_BASE_WINDOW_WIDTH) {
+                throw invalid_argument(
+                    "The 'windowWidth' parameter cannot be equal to "
+                    + to_string(windowWidth)
+                );
+            }
+        }
+
+        PublicKeyCache(const PublicKeyCache& other) = delete;
+
+        PublicKeyCache& operator=(const PublicKeyCache& other) = delete;
+
+        /**
+         * Returns the table of the public key, building it on a miss.
+         * The table is built outside the lock, so two threads that miss
+         * on the same key at once may both build it. Returns nullptr if
+         * the table would be larger than the whole budget.
+         */
+        shared_ptr<const FixedBaseMultiplication> get(
+            const PublicKey& publicKey,
+            const BigInt& order,
+            const BigInt::Context& ctx = BigInt::Context()
+        ) {
+            const string key = getKey(publicKey, ctx);
+            {
+                const lock_guard<mutex> lock(this->cacheMutex);
+                const auto it = this->index.find(key);
+                if (it != this->index.end()) {
+                    ++this->statistics.hits;
+                    this->entries.splice(
+                        this->entries.begin(), this->entries, it->second
+                    );
+                    return it->second->second;
+                }
+                ++this->statistics.misses;
+                if (
+                    FixedBaseMultiplication::estimateMemoryUsage(
+                        publicKey, order, this->windowWidth
+                    ) > this->memoryBudget
+                ) {
+                    return nullptr;
+                }
+            }
+
+            const Table table = make_shared<const FixedBaseMultiplication>(
+                publicKey, order, this->windowWidth
+            );
+            const size_t size = table->getMemoryUsage();
+
+            const lock_guard<mutex> lock(this->cacheMutex);
+            const auto it = this->index.find(key);
+            if (it != this->index.end()) {
+                this->entries.splice(
+                    this->entries.begin(), this->entries, it->second
+                );
+                return it->second->second;
+            }
+            this->entries.emplace_front(key, table);
+            this->index.emplace(key, this->entries.begin());
+            this->statistics.memoryUsage += size;
+            this->evict();
+            return table;
+        }
+
+        Statistics getStatistics() const {
+            const lock_guard<mutex> lock(this->cacheMutex);
+            Statistics result = this->statistics;
+            result.numberOfEntries = this->entries.size();
+            return result;
+        }
+
+        size_t getMemoryBudget() const {
+            const lock_guard<mutex> lock(this->cacheMutex);
+            return this->memoryBudget;
+        }
+
+        void setMemoryBudget(const size_t memoryBudget) {
+            const lock_guard<mutex> lock(this->cacheMutex);
+            this->memoryBudget = memoryBudget;
+            this->evict();
+        }
+
+        void clear() {
+            const lock_guard<mutex> lock(this->cacheMutex);
+            this->entries.clear();
+            this->index.clear();
+            this->statistics.memoryUsage = 0;
+        }
+    };
+}
+
+#endif // PUBLIC_KEY_CACHE_H_INCLUDED
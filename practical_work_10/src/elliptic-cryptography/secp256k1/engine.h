@@ -0,0 +1,778 @@
+#ifndef SECP256K1_ENGINE_H_INCLUDED
+#define SECP256K1_ENGINE_H_INCLUDED
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <openssl/ec.h>
+#include <openssl/obj_mac.h>
+#include "../../definitions.h"
+#include "../../big-int.h"
+#include "../../fixed-big-int.h"
+#include "../../thread-pool.h"
+#include "field-element.h"
+#include "jacobian-point.h"
+#include "projective-point.h"
+
+using namespace std;
+
+namespace EllipticCryptography::Secp256k1 {
+    using Scalar = FixedBigInt<256>;
+
+    /**
+     * Scalar multiplication on secp256k1 with native field arithmetic.
+     * Points are exchanged with OpenSSL in their uncompressed encoding.
+     *
+     * k * G and k * P take secret scalars, e.g. a nonce or a private
+     * key, and run in constant time. The scalar is read in fixed 4-bit
+     * windows, from a table of d * 2^(4j) * G in affine form built on
+     * first use, or from the multiples 0 * P, ..., 15 * P. Every window
+     * reads all the entries of its table and adds the chosen one with
+     * complete projective formulas, so neither the branches nor the
+     * memory accesses depend on the scalar.
+     *
+     * The scalars of verification are public, and its paths trade that
+     * for speed with the GLV method: the curve has an endomorphism
+     * (x, y) -> (beta * x, y) that acts as multiplication by lambda, so
+     * a multiple of P is evaluated as k1 * P + k2 * (lambda * P) with k1
+     * and k2 of about 128 bits, and the two halves share one chain of 128
+     * doublings. The halves are recoded in wNAF, so only odd multiples
+     * are tabulated and about one in six bits costs an addition.
+     * u1 * G + u2 * Q splits both scalars the same way into four
+     * interleaved terms, with a wider window and a static table for the
+     * two terms of G.
+     */
+    class Engine {
+    private:
+        static constexpr size_t WINDOW_WIDTH = 4;
+        static constexpr size_t ENCODED_POINT_SIZE = 1 + 2 * FIELD_ELEMENT_SIZE;
+
+        /**
+         * Window widths of the wNAF digits used for arbitrary points and,
+         * with a larger table kept for the whole process, for G.
+         */
+        static constexpr size_t WNAF_WINDOW_WIDTH = 5;
+        static constexpr size_t GENERATOR_WNAF_WINDOW_WIDTH = 8;
+        static constexpr size_t MAX_WNAF_LENGTH = 256 + 1;
+        static constexpr size_t MAX_BUCKET_WINDOW_WIDTH = 20;
+
+        static constexpr Scalar GENERATOR_X = Scalar::fromHex(
+            "79BE667EF9DCBBAC55A06295CE870B07029BFCDB2DCE28D959F2815B16F81798"
+        );
+        static constexpr Scalar GENERATOR_Y = Scalar::fromHex(
+            "483ADA7726A3C4655DA4FBFC0E1108A8FD17B448A68554199C47D08FFB10D4B8"
+        );
+
+        /**
+         * A cube root of unity modulo p.
+         */
+        static constexpr Scalar BETA = Scalar::fromHex(
+            "7AE96A2B657C07106E64479EAC3434E99CF0497512F58995C1396C28719501EE"
+        );
+
+        /**
+         * Signed scalar of at most 256 bits.
+         */
+        struct SignedScalar {
+        public:
+            Scalar magnitude;
+            bool negative = false;
+
+        public:
+            SignedScalar() = default;
+
+            explicit SignedScalar(const BigInt& value)
+            :   magnitude(value < 0 ? -value : value),
+                negative(value < 0)
+            {}
+        };
+
+        /**
+         * A scalar multiplication term: the scalar in width-w NAF, where
+         * every nonzero digit is odd and followed by at least w - 1 zeros,
+         * and the odd multiples P, 3P, ..., (2^(w-1) - 1)P of its point.
+         */
+        struct Term {
+        public:
+            span<const AffinePoint> oddMultiples;
+            array<int8_t, MAX_WNAF_LENGTH> digits {};
+            size_t length = 0;
+
+        public:
+            Term(
+                span<const AffinePoint> oddMultiples,
+                const SignedScalar& scalar,
+                const size_t windowWidth
+            )
+            :   oddMultiples(oddMultiples)
+            {
+                const Scalar& k = scalar.magnitude;
+                const size_t numberOfBits = k.getNumberOfBits();
+                const int sign = scalar.negative ? -1 : 1;
+                Word carry = 0;
+                size_t bit = 0;
+                while (bit < numberOfBits + 1) {
+                    if (k.getBits(bit, 1) == carry) {
+                        ++bit;
+                        continue;
+                    }
+                    const size_t width = min(windowWidth, numberOfBits + 1 - bit);
+                    long digit = static_cast<long>(k.getBits(bit, width) + carry);
+                    carry = (digit >> (windowWidth - 1)) & 1;
+                    digit -= static_cast<long>(carry << windowWidth);
+                    this->digits[bit] = static_cast<int8_t>(sign * digit);
+                    this->length = bit + 1;
+                    bit += width;
+                }
+            }
+        };
+
+    private:
+        static FieldElement toFieldElement(const Scalar& value) {
+            array<Byte, FIELD_ELEMENT_SIZE> bytes;
+            value.toBytes(bytes);
+            return FieldElement::fromBytes(bytes);
+        }
+
+        static const BigInt& getOrder() {
+            static const BigInt order(
+                "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEBAAEDCE6AF48A03BBFD25E8CD0364141",
+                Radix::HEX
+            );
+            return order;
+        }
+
+        static const FieldElement& getBeta() {
+            static const FieldElement beta = toFieldElement(BETA);
+            return beta;
+        }
+
+        /**
+         * Splits k into k1 + k2 * lambda (mod n) with |k1|, |k2| < 2^129,
+         * by rounding k to the nearest point of the lattice spanned by
+         * (a1, b1) and (a2, b2), which both map to 0 under k1 + k2 * lambda.
+         */
+        static pair<SignedScalar, SignedScalar> split(
+            const BigInt& k, const BigInt::Context& ctx
+        ) {
+            static const BigInt a1("3086D221A7D46BCDE86C90E49284EB15", Radix::HEX);
+            static const BigInt minusB1("E4437ED6010E88286F547FA90ABFE4C3", Radix::HEX);
+            static const BigInt a2("114CA50F7A8E2F3F657C1108D9D44CFD8", Radix::HEX);
+            const BigInt& b2 = a1;
+            const BigInt& n = getOrder();
+            static const BigInt halfN = n / 2;
+
+            const BigInt reduced = !(k < 0) && k < n ? k : BigInt::mod(k, n, ctx);
+            BigInt c1 = b2 * reduced;
+            c1 += halfN;
+            c1 = c1 / n;
+            BigInt c2 = minusB1 * reduced;
+            c2 += halfN;
+            c2 = c2 / n;
+
+            BigInt k1 = reduced - c1 * a1;
+            k1 -= c2 * a2;
+            BigInt k2 = c1 * minusB1;
+            k2 -= c2 * b2;
+            return {SignedScalar(k1), SignedScalar(k2)};
+        }
+
+        /**
+         * Returns the odd multiples P, 3P, ..., (2^(w-1) - 1)P of a point,
+         * followed by the same multiples of lambda * P, which only differ
+         * in x by a factor of beta.
+         */
+        template<size_t WindowWidth>
+        static array<AffinePoint, 2 << (WindowWidth - 2)> getOddMultiples(
+            const AffinePoint& point
+        ) {
+            constexpr size_t numberOfMultiples = 1 << (WindowWidth - 2);
+            array<JacobianPoint, numberOfMultiples> multiples;
+            multiples[0] = JacobianPoint(point);
+            const JacobianPoint doubled = multiples[0].doubled();
+            for (size_t i = 1; i < numberOfMultiples; ++i) {
+                multiples[i] = multiples[i - 1] + doubled;
+            }
+            array<AffinePoint, 2 * numberOfMultiples> result;
+            JacobianPoint::toAffine(
+                multiples, span(result).template first<numberOfMultiples>()
+            );
+            for (size_t i = 0; i < numberOfMultiples; ++i) {
+                result[numberOfMultiples + i] = result[i];
+                result[numberOfMultiples + i].x = result[i].x * getBeta();
+            }
+            return result;
+        }
+
+        static const auto& getGeneratorOddMultiples() {
+            static const auto multiples =
+                getOddMultiples<GENERATOR_WNAF_WINDOW_WIDTH>(AffinePoint(
+                    toFieldElement(GENERATOR_X), toFieldElement(GENERATOR_Y)
+                ));
+            return multiples;
+        }
+
+        /**
+         * Straus' interleaving of several terms with one doubling chain.
+         */
+        static JacobianPoint multiply(span<const Term> terms) {
+            size_t length = 0;
+            for (const Term& term : terms) {
+                length = max(length, term.length);
+            }
+            JacobianPoint result;
+            for (size_t bit = length; bit-- > 0;) {
+                result = result.doubled();
+                for (const Term& term : terms) {
+                    const int digit = term.digits[bit];
+                    if (digit > 0) {
+                        result = result + term.oddMultiples[digit / 2];
+                    } else if (digit < 0) {
+                        result = result + term.oddMultiples[-digit / 2].negated();
+                    }
+                }
+            }
+            return result;
+        }
+
+        /**
+         * Builds the comb table d * 2^(w * j) * base for every nonzero
+         * w-bit digit d and every window j of a 256-bit scalar.
+         */
+        static vector<AffinePoint> computeCombTable(
+            const AffinePoint& base, const size_t windowWidth
+        ) {
+            const size_t rowLength = (size_t(1) << windowWidth) - 1;
+            const size_t numberOfWindows = (256 + windowWidth - 1) / windowWidth;
+            vector<JacobianPoint> multiples;
+            multiples.reserve(numberOfWindows * rowLength);
+            JacobianPoint rowBase(base);
+            for (size_t row = 0; row < numberOfWindows; ++row) {
+                multiples.push_back(rowBase);
+                for (size_t d = 1; d < rowLength; ++d) {
+                    multiples.push_back(multiples.back() + rowBase);
+                }
+                rowBase = multiples.back() + rowBase;
+            }
+            vector<AffinePoint> result(multiples.size());
+            JacobianPoint::toAffine(multiples, result);
+            return result;
+        }
+
+        static void addCombMultiple(
+            JacobianPoint& result,
+            span<const AffinePoint> table,
+            const size_t windowWidth,
+            const Scalar& k
+        ) {
+            const size_t rowLength = (size_t(1) << windowWidth) - 1;
+            const size_t numberOfWindows = table.size() / rowLength;
+            for (size_t window = 0; window < numberOfWindows; ++window) {
+                const size_t digit = k.getBits(window * windowWidth, windowWidth);
+                if (digit) {
+                    result = result + table[window * rowLength + digit - 1];
+                }
+            }
+        }
+
+        static const vector<AffinePoint>& getGeneratorTable() {
+            static const vector<AffinePoint> table = computeCombTable(
+                AffinePoint(
+                    toFieldElement(GENERATOR_X), toFieldElement(GENERATOR_Y)
+                ),
+                WINDOW_WIDTH
+            );
+            return table;
+        }
+
+        static Scalar toScalar(const BigInt& k, const BigInt::Context& ctx) {
+            const BigInt& n = getOrder();
+            if (!(k < 0) && k < n) {
+                return Scalar(k);
+            }
+            return Scalar(BigInt::mod(k, n, ctx));
+        }
+
+        /**
+         * Returns 1 if a == b and 0 otherwise, without branching.
+         */
+        static uint64_t isEqual(const size_t a, const size_t b) {
+            return ((uint64_t(a ^ b) | -uint64_t(a ^ b)) >> 63) ^ 1;
+        }
+
+        /**
+         * Reads entry digit - 1 of the row, or a point with zero
+         * coordinates if the digit is 0, touching every entry.
+         */
+        static AffinePoint lookup(span<const AffinePoint> row, const size_t digit) {
+            AffinePoint result(0, 0);
+            for (size_t i = 0; i < row.size(); ++i) {
+                const uint64_t flag = isEqual(i + 1, digit);
+                result.x.conditionalMove(row[i].x, flag);
+                result.y.conditionalMove(row[i].y, flag);
+            }
+            return result;
+        }
+
+        /**
+         * Reads entry digit of the row, touching every entry.
+         */
+        static ProjectivePoint lookup(
+            span<const ProjectivePoint> row, const size_t digit
+        ) {
+            ProjectivePoint result;
+            for (size_t i = 0; i < row.size(); ++i) {
+                result.conditionalMove(row[i], isEqual(i, digit));
+            }
+            return result;
+        }
+
+        /**
+         * Sums one entry of every row of the comb table of G. A zero
+         * digit still costs a lookup and an addition, whose result is
+         * then dropped.
+         */
+        static ProjectivePoint multiplyGenerator(const Scalar& k) {
+            const vector<AffinePoint>& table = getGeneratorTable();
+            constexpr size_t rowLength = (size_t(1) << WINDOW_WIDTH) - 1;
+            ProjectivePoint result;
+            for (size_t window = 0; window < table.size() / rowLength; ++window) {
+                const size_t digit = k.getBits(window * WINDOW_WIDTH, WINDOW_WIDTH);
+                const AffinePoint entry = lookup(
+                    span(table).subspan(window * rowLength, rowLength), digit
+                );
+                result.conditionalMove(result + entry, isEqual(digit, 0) ^ 1);
+            }
+            return result;
+        }
+
+        /**
+         * Fixed-window multiplication from the top: four doublings and
+         * one addition of d * P per window, with 0 * P at infinity.
+         */
+        static ProjectivePoint multiply(const AffinePoint& point, const Scalar& k) {
+            array<ProjectivePoint, size_t(1) << WINDOW_WIDTH> multiples;
+            multiples[1] = ProjectivePoint(point);
+            for (size_t d = 2; d < multiples.size(); ++d) {
+                multiples[d] = multiples[d - 1] + multiples[1];
+            }
+            ProjectivePoint result;
+            for (size_t window = 256 / WINDOW_WIDTH; window-- > 0;) {
+                for (size_t i = 0; i < WINDOW_WIDTH; ++i) {
+                    result = result.doubled();
+                }
+                const size_t digit = k.getBits(window * WINDOW_WIDTH, WINDOW_WIDTH);
+                result = result + lookup(multiples, digit);
+            }
+            return result;
+        }
+
+        /**
+         * Picks the bucket window width c that minimises the number of
+         * additions: every window adds each point into a bucket once and
+         * then sums its 2^(c-1) buckets with two additions per bucket.
+         */
+        static size_t getBucketWindowWidth(
+            const size_t numberOfPoints, const size_t numberOfBits
+        ) {
+            size_t best = 1;
+            size_t bestCost = numeric_limits<size_t>::max();
+            for (size_t c = 1; c <= MAX_BUCKET_WINDOW_WIDTH; ++c) {
+                const size_t numberOfWindows = numberOfBits / c + 1;
+                const size_t cost =
+                    numberOfWindows * (numberOfPoints + (size_t(2) << (c - 1)));
+                if (cost < bestCost) {
+                    best = c;
+                    bestCost = cost;
+                }
+            }
+            return best;
+        }
+
+        /**
+         * Sums digits[i] * points[i] for the signed digits of one window
+         * with 2^(c-1) buckets: the points are added into the bucket of
+         * their digit, and the running sum of the buckets from the top
+         * adds bucket d to the total exactly d times.
+         */
+        static JacobianPoint sumWindow(
+            span<const AffinePoint> points,
+            span<const int32_t> digits,
+            const size_t numberOfWindows,
+            const size_t window,
+            const size_t windowWidth
+        ) {
+            vector<JacobianPoint> buckets(size_t(1) << (windowWidth - 1));
+            for (size_t i = 0; i < points.size(); ++i) {
+                const int32_t digit = digits[i * numberOfWindows + window];
+                if (digit > 0) {
+                    buckets[digit - 1] = buckets[digit - 1] + points[i];
+                } else if (digit < 0) {
+                    buckets[-digit - 1] = buckets[-digit - 1] + points[i].negated();
+                }
+            }
+            JacobianPoint runningSum;
+            JacobianPoint result;
+            for (size_t b = buckets.size(); b-- > 0;) {
+                runningSum = runningSum + buckets[b];
+                result = result + runningSum;
+            }
+            return result;
+        }
+
+        static AffinePoint load(
+            const EC_GROUP* group, const EC_POINT* point, BN_CTX* ctx
+        ) {
+            if (EC_POINT_is_at_infinity(group, point)) {
+                return AffinePoint();
+            }
+            array<Byte, ENCODED_POINT_SIZE> encoded;
+            if (EC_POINT_point2oct(
+                group,
+                point,
+                POINT_CONVERSION_UNCOMPRESSED,
+                encoded.data(),
+                encoded.size(),
+                ctx
+            ) != encoded.size()) {
+                throw runtime_error(OPERATION_FAILED);
+            }
+            const span<const Byte> coordinates(encoded);
+            return AffinePoint(
+                FieldElement::fromBytes(
+                    coordinates.subspan<1, FIELD_ELEMENT_SIZE>()
+                ),
+                FieldElement::fromBytes(
+                    coordinates.subspan<1 + FIELD_ELEMENT_SIZE, FIELD_ELEMENT_SIZE>()
+                )
+            );
+        }
+
+        static void store(
+            const EC_GROUP* group,
+            EC_POINT* result,
+            const JacobianPoint& point,
+            BN_CTX* ctx
+        ) {
+            store(group, result, point.toAffine(), ctx);
+        }
+
+        static void store(
+            const EC_GROUP* group,
+            EC_POINT* result,
+            const ProjectivePoint& point,
+            BN_CTX* ctx
+        ) {
+            store(group, result, point.toAffine(), ctx);
+        }
+
+        static void store(
+            const EC_GROUP* group,
+            EC_POINT* result,
+            const AffinePoint& affine,
+            BN_CTX* ctx
+        ) {
+            if (affine.infinity) {
+                if (!EC_POINT_set_to_infinity(group, result)) {
+                    throw runtime_error(OPERATION_FAILED);
+                }
+                return;
+            }
+            array<Byte, ENCODED_POINT_SIZE> encoded;
+            const span<Byte> coordinates(encoded);
+            encoded[0] = POINT_CONVERSION_UNCOMPRESSED;
+            affine.x.toBytes(coordinates.subspan<1, FIELD_ELEMENT_SIZE>());
+            affine.y.toBytes(
+                coordinates.subspan<1 + FIELD_ELEMENT_SIZE, FIELD_ELEMENT_SIZE>()
+            );
+            if (!EC_POINT_oct2point(
+                group, result, encoded.data(), encoded.size(), ctx
+            )) {
+                throw runtime_error(OPERATION_FAILED);
+            }
+        }
+
+    public:
+        static bool isSupported(const EC_GROUP* group) {
+            return EC_GROUP_get_curve_name(group) == NID_secp256k1;
+        }
+
+        /**
+         * Recovers the point with the given x and parity of y from
+         * y^2 = x^3 + 7. Returns false if x is not below p or is not the
+         * x of any point.
+         */
+        static bool decompress(
+            const EC_GROUP* group,
+            EC_POINT* result,
+            span<const Byte, FIELD_ELEMENT_SIZE> x,
+            const bool isYOdd,
+            BN_CTX* ctx
+        ) {
+            const FieldElement px = FieldElement::fromBytes(x);
+            array<Byte, FIELD_ELEMENT_SIZE> canonical;
+            px.toBytes(canonical);
+            if (!equal(canonical.begin(), canonical.end(), x.begin())) {
+                return false;
+            }
+            const FieldElement rhs = px.squared() * px + FieldElement(7);
+            FieldElement py = rhs.squareRoot();
+            if (!(py.squared() == rhs)) {
+                return false;
+            }
+            if (py.isOdd() != isYOdd) {
+                py = -py;
+            }
+            store(group, result, AffinePoint(px, py), ctx);
+            return true;
+        }
+
+        /**
+         * Computes k * G for a secret k.
+         */
+        static void multiplyGenerator(
+            const EC_GROUP* group,
+            EC_POINT* result,
+            const BigInt& k,
+            const BigInt::Context& ctx
+        ) {
+            store(group, result, multiplyGenerator(toScalar(k, ctx)), ctx.data);
+        }
+
+        /**
+         * Builds a comb table for a point that is used as a fixed base, see
+         * multiply and mulAdd below.
+         */
+        static vector<AffinePoint> computeTable(
+            const EC_GROUP* group,
+            const EC_POINT* point,
+            const size_t windowWidth,
+            const BigInt::Context& ctx
+        ) {
+            return computeCombTable(load(group, point, ctx.data), windowWidth);
+        }
+
+        /**
+         * Computes k * base from the comb table of the base, for a public
+         * k.
+         */
+        static void multiply(
+            const EC_GROUP* group,
+            EC_POINT* result,
+            span<const AffinePoint> table,
+            const size_t windowWidth,
+            const BigInt& k,
+            const BigInt::Context& ctx
+        ) {
+            JacobianPoint sum;
+            addCombMultiple(sum, table, windowWidth, toScalar(k, ctx));
+            store(group, result, sum, ctx.data);
+        }
+
+        /**
+         * Computes u1 * G + u2 * base from the comb tables of G and of the
+         * base, with no doublings at all.
+         */
+        static void mulAdd(
+            const EC_GROUP* group,
+            EC_POINT* result,
+            const BigInt& u1,
+            const BigInt& u2,
+            span<const AffinePoint> table,
+            const size_t windowWidth,
+            const BigInt::Context& ctx
+        ) {
+            JacobianPoint sum;
+            addCombMultiple(sum, getGeneratorTable(), WINDOW_WIDTH, toScalar(u1, ctx));
+            addCombMultiple(sum, table, windowWidth, toScalar(u2, ctx));
+            store(group, result, sum, ctx.data);
+        }
+
+        /**
+         * Computes k * point for a secret k.
+         */
+        static void multiply(
+            const EC_GROUP* group,
+            EC_POINT* result,
+            const EC_POINT* point,
+            const BigInt& k,
+            const BigInt::Context& ctx
+        ) {
+            const AffinePoint affine = load(group, point, ctx.data);
+            if (affine.infinity) {
+                store(group, result, affine, ctx.data);
+                return;
+            }
+            store(group, result, multiply(affine, toScalar(k, ctx)), ctx.data);
+        }
+
+        /**
+         * Computes u1 * G + u2 * point.
+         */
+        static void mulAdd(
+            const EC_GROUP* group,
+            EC_POINT* result,
+            const BigInt& u1,
+            const BigInt& u2,
+            const EC_POINT* point,
+            const BigInt::Context& ctx
+        ) {
+            const span<const AffinePoint> generatorTable(
+                getGeneratorOddMultiples()
+            );
+            const auto multiples = getOddMultiples<WNAF_WINDOW_WIDTH>(
+                load(group, point, ctx.data)
+            );
+            const span<const AffinePoint> table(multiples);
+            const auto [g1, g2] = split(u1, ctx);
+            const auto [q1, q2] = split(u2, ctx);
+            const Term terms[] {
+                {
+                    generatorTable.first(generatorTable.size() / 2),
+                    g1,
+                    GENERATOR_WNAF_WINDOW_WIDTH
+                },
+                {
+                    generatorTable.last(generatorTable.size() / 2),
+                    g2,
+                    GENERATOR_WNAF_WINDOW_WIDTH
+                },
+                {table.first(table.size() / 2), q1, WNAF_WINDOW_WIDTH},
+                {table.last(table.size() / 2), q2, WNAF_WINDOW_WIDTH},
+            };
+            store(group, result, multiply(terms), ctx.data);
+        }
+
+        /**
+         * Computes the sum of scalars[i] * points[i]. Every point is split
+         * into two GLV terms and the odd multiples of all the points are
+         * converted to affine form with a single field inversion.
+         */
+        static void linearCombination(
+            const EC_GROUP* group,
+            EC_POINT* result,
+            span<const BigInt> scalars,
+            span<const EC_POINT* const> points,
+            const BigInt::Context& ctx
+        ) {
+            constexpr size_t numberOfMultiples = 1 << (WNAF_WINDOW_WIDTH - 2);
+            vector<JacobianPoint> multiples(points.size() * numberOfMultiples);
+            for (size_t i = 0; i < points.size(); ++i) {
+                JacobianPoint* row = &multiples[i * numberOfMultiples];
+                row[0] = JacobianPoint(load(group, points[i], ctx.data));
+                const JacobianPoint doubled = row[0].doubled();
+                for (size_t j = 1; j < numberOfMultiples; ++j) {
+                    row[j] = row[j - 1] + doubled;
+                }
+            }
+            vector<AffinePoint> oddMultiples(multiples.size());
+            JacobianPoint::toAffine(multiples, oddMultiples);
+
+            vector<AffinePoint> table(2 * oddMultiples.size());
+            vector<Term> terms;
+            terms.reserve(2 * points.size());
+            for (size_t i = 0; i < points.size(); ++i) {
+                const span<AffinePoint> row =
+                    span(table).subspan(2 * i * numberOfMultiples, 2 * numberOfMultiples);
+                for (size_t j = 0; j < numberOfMultiples; ++j) {
+                    row[j] = oddMultiples[i * numberOfMultiples + j];
+                    row[numberOfMultiples + j] = row[j];
+                    row[numberOfMultiples + j].x = row[j].x * getBeta();
+                }
+                const auto [k1, k2] = split(scalars[i], ctx);
+                terms.emplace_back(row.first(numberOfMultiples), k1, WNAF_WINDOW_WIDTH);
+                terms.emplace_back(row.last(numberOfMultiples), k2, WNAF_WINDOW_WIDTH);
+            }
+            store(group, result, multiply(terms), ctx.data);
+        }
+
+        /**
+         * Computes the sum of scalars[i] * points[i] with Pippenger's
+         * bucket method. After the GLV split every scalar is recoded into
+         * signed c-bit digits, with c chosen by the number of points, and
+         * each window is summed through 2^(c-1) buckets. The windows are
+         * independent and run on the thread pool if one is given.
+         * For thousands of points this needs far fewer additions than the
+         * interleaved linearCombination.
+         */
+        static void multiScalarMultiply(
+            const EC_GROUP* group,
+            EC_POINT* result,
+            span<const BigInt> scalars,
+            span<const EC_POINT* const> points,
+            ThreadPool* threadPool,
+            const BigInt::Context& ctx
+        ) {
+            vector<AffinePoint> bases;
+            vector<Scalar> magnitudes;
+            bases.reserve(2 * points.size());
+            magnitudes.reserve(2 * points.size());
+            size_t numberOfBits = 0;
+            for (size_t i = 0; i < points.size(); ++i) {
+                const AffinePoint point = load(group, points[i], ctx.data);
+                if (point.infinity) {
+                    continue;
+                }
+                AffinePoint lambdaPoint = point;
+                lambdaPoint.x = point.x * getBeta();
+                const auto [k1, k2] = split(scalars[i], ctx);
+                bases.push_back(k1.negative ? point.negated() : point);
+                magnitudes.push_back(k1.magnitude);
+                bases.push_back(k2.negative ? lambdaPoint.negated() : lambdaPoint);
+                magnitudes.push_back(k2.magnitude);
+                numberOfBits = max({
+                    numberOfBits,
+                    k1.magnitude.getNumberOfBits(),
+                    k2.magnitude.getNumberOfBits()
+                });
+            }
+
+            const size_t windowWidth =
+                getBucketWindowWidth(bases.size(), numberOfBits);
+            const size_t numberOfWindows = numberOfBits / windowWidth + 1;
+            const long half = long(1) << (windowWidth - 1);
+            vector<int32_t> digits(bases.size() * numberOfWindows);
+            for (size_t i = 0; i < bases.size(); ++i) {
+                long carry = 0;
+                for (size_t window = 0; window < numberOfWindows; ++window) {
+                    long digit = static_cast<long>(magnitudes[i].getBits(
+                        window * windowWidth, windowWidth
+                    )) + carry;
+                    carry = digit > half;
+                    digit -= carry << windowWidth;
+                    digits[i * numberOfWindows + window] = static_cast<int32_t>(digit);
+                }
+            }
+
+            vector<JacobianPoint> windowSums(numberOfWindows);
+            const auto sumWindows = [&](const size_t begin, const size_t end) {
+                for (size_t window = begin; window < end; ++window) {
+                    windowSums[window] = sumWindow(
+                        bases, digits, numberOfWindows, window, windowWidth
+                    );
+                }
+            };
+            if (threadPool) {
+                threadPool->forEachShard(numberOfWindows, 1, sumWindows);
+            } else {
+                sumWindows(0, numberOfWindows);
+            }
+
+            JacobianPoint sum;
+            for (size_t window = numberOfWindows; window-- > 0;) {
+                for (size_t i = 0; i < windowWidth; ++i) {
+                    sum = sum.doubled();
+                }
+                sum = sum + windowSums[window];
+            }
+            store(group, result, sum, ctx.data);
+        }
+    };
+}
+
+#endif // SECP256K1_ENGINE_H_INCLUDED
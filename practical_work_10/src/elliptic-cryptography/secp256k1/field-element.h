@@ -0,0 +1,388 @@
+#ifndef SECP256K1_FIELD_ELEMENT_H_INCLUDED
+#define SECP256K1_FIELD_ELEMENT_H_INCLUDED
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include "../../definitions.h"
+
+using namespace std;
+
+namespace EllipticCryptography::Secp256k1 {
+    const size_t FIELD_ELEMENT_SIZE = 32;
+
+    /**
+     * Element of the field of integers modulo p = 2^256 - 2^32 - 977.
+     *
+     * The value is kept in five 52-bit limbs, least significant first,
+     * so products of limbs fit in 128 bits with room to accumulate.
+     * Reduction uses 2^256 = 2^32 + 977 (mod p). Every operation returns
+     * a weakly normalized element: the limbs fit in 52 bits (48 for the
+     * top one) but the value itself may still exceed p. The canonical
+     * value is only computed when an element is compared or serialized.
+     */
+    class FieldElement {
+    private:
+        using Limb = uint64_t;
+        using DoubleLimb = unsigned __int128;
+
+        static constexpr size_t NUMBER_OF_LIMBS = 5;
+        static constexpr size_t BITS_PER_LIMB = 52;
+        static constexpr Limb LIMB_MASK = 0xFFFFFFFFFFFFF;
+        static constexpr Limb TOP_LIMB_MASK = 0x0FFFFFFFFFFFF;
+        static constexpr size_t TOP_LIMB_BITS = 48;
+
+        /**
+         * 2^256 mod p and 2^260 mod p.
+         */
+        static constexpr Limb REDUCTION = 0x1000003D1;
+        static constexpr Limb SHIFTED_REDUCTION = REDUCTION << 4;
+
+        /**
+         * The limbs of p.
+         */
+        static constexpr array<Limb, NUMBER_OF_LIMBS> MODULUS {
+            0xFFFFEFFFFFC2F,
+            LIMB_MASK,
+            LIMB_MASK,
+            LIMB_MASK,
+            TOP_LIMB_MASK,
+        };
+
+    private:
+        array<Limb, NUMBER_OF_LIMBS> n {};
+
+    private:
+        void normalizeWeakly() {
+            Limb* n = this->n.data();
+            const Limb x = n[4] >> TOP_LIMB_BITS;
+            n[4] &= TOP_LIMB_MASK;
+            n[0] += x * REDUCTION;
+            n[1] += n[0] >> BITS_PER_LIMB;
+            n[0] &= LIMB_MASK;
+            n[2] += n[1] >> BITS_PER_LIMB;
+            n[1] &= LIMB_MASK;
+            n[3] += n[2] >> BITS_PER_LIMB;
+            n[2] &= LIMB_MASK;
+            n[4] += n[3] >> BITS_PER_LIMB;
+            n[3] &= LIMB_MASK;
+        }
+
+        /**
+         * Brings the value into [0, p).
+         */
+        FieldElement normalized() const {
+            FieldElement result = *this;
+            result.normalizeWeakly();
+            Limb* n = result.n.data();
+            const bool isAtLeastModulus =
+                (n[4] >> TOP_LIMB_BITS)
+                || (
+                    n[4] == TOP_LIMB_MASK
+                    && (n[3] & n[2] & n[1]) == LIMB_MASK
+                    && n[0] >= MODULUS[0]
+                );
+            if (isAtLeastModulus) {
+                n[0] += REDUCTION;
+                n[1] += n[0] >> BITS_PER_LIMB;
+                n[0] &= LIMB_MASK;
+                n[2] += n[1] >> BITS_PER_LIMB;
+                n[1] &= LIMB_MASK;
+                n[3] += n[2] >> BITS_PER_LIMB;
+                n[2] &= LIMB_MASK;
+                n[4] += n[3] >> BITS_PER_LIMB;
+                n[3] &= LIMB_MASK;
+                n[4] &= TOP_LIMB_MASK;
+            }
+            return result;
+        }
+
+        FieldElement squared(const size_t times) const {
+            FieldElement result = *this;
+            for (size_t i = 0; i < times; ++i) {
+                result = result.squared();
+            }
+            return result;
+        }
+
+    public:
+        constexpr FieldElement() = default;
+
+        /**
+         * Creates an element from a value below 2^52.
+         */
+        constexpr FieldElement(const Limb value) : n {value & LIMB_MASK} {}
+
+        /**
+         * Reads a 32-byte big-endian value. Values in [p, 2^256) are
+         * accepted and reduced lazily.
+         */
+        static FieldElement fromBytes(span<const Byte, FIELD_ELEMENT_SIZE> bytes) {
+            FieldElement result;
+            for (size_t i = 0; i < FIELD_ELEMENT_SIZE; ++i) {
+                const size_t position = i * BITS_PER_BYTE;
+                const Limb byte = bytes[FIELD_ELEMENT_SIZE - 1 - i];
+                const size_t index = position / BITS_PER_LIMB;
+                const size_t shift = position % BITS_PER_LIMB;
+                result.n[index] |= (byte << shift) & LIMB_MASK;
+                if (shift + BITS_PER_BYTE > BITS_PER_LIMB) {
+                    result.n[index + 1] |= byte >> (BITS_PER_LIMB - shift);
+                }
+            }
+            return result;
+        }
+
+        void toBytes(span<Byte, FIELD_ELEMENT_SIZE> bytes) const {
+            const FieldElement value = this->normalized();
+            for (size_t i = 0; i < FIELD_ELEMENT_SIZE; ++i) {
+                const size_t position = i * BITS_PER_BYTE;
+                const size_t index = position / BITS_PER_LIMB;
+                const size_t shift = position % BITS_PER_LIMB;
+                Limb byte = value.n[index] >> shift;
+                if (shift + BITS_PER_BYTE > BITS_PER_LIMB) {
+                    byte |= value.n[index + 1] << (BITS_PER_LIMB - shift);
+                }
+                bytes[FIELD_ELEMENT_SIZE - 1 - i] = static_cast<Byte>(byte);
+            }
+        }
+
+        bool isZero() const {
+            const FieldElement value = this->normalized();
+            return !(
+                value.n[0] | value.n[1] | value.n[2] | value.n[3] | value.n[4]
+            );
+        }
+
+        bool isOdd() const {
+            return this->normalized().n[0] & 1;
+        }
+
+        /**
+         * Replaces the value with the other one if the flag is 1 and keeps
+         * it if the flag is 0, without branching on the flag.
+         */
+        void conditionalMove(const FieldElement& other, const Limb flag) {
+            const Limb mask = Limb(0) - flag;
+            for (size_t i = 0; i < NUMBER_OF_LIMBS; ++i) {
+                this->n[i] ^= (this->n[i] ^ other.n[i]) & mask;
+            }
+        }
+
+        FieldElement operator+(const FieldElement& other) const {
+            FieldElement result;
+            for (size_t i = 0; i < NUMBER_OF_LIMBS; ++i) {
+                result.n[i] = this->n[i] + other.n[i];
+            }
+            result.normalizeWeakly();
+            return result;
+        }
+
+        /**
+         * Computes 4p - a, which needs no borrows for a weakly normalized a.
+         */
+        FieldElement operator-() const {
+            FieldElement result;
+            for (size_t i = 0; i < NUMBER_OF_LIMBS; ++i) {
+                result.n[i] = 4 * MODULUS[i] - this->n[i];
+            }
+            result.normalizeWeakly();
+            return result;
+        }
+
+        FieldElement operator-(const FieldElement& other) const {
+            FieldElement result;
+            for (size_t i = 0; i < NUMBER_OF_LIMBS; ++i) {
+                result.n[i] = this->n[i] + 4 * MODULUS[i] - other.n[i];
+            }
+            result.normalizeWeakly();
+            return result;
+        }
+
+        /**
+         * Multiplies by a small constant (at most 2^8).
+         */
+        FieldElement operator*(const Limb factor) const {
+            FieldElement result;
+            for (size_t i = 0; i < NUMBER_OF_LIMBS; ++i) {
+                result.n[i] = this->n[i] * factor;
+            }
+            result.normalizeWeakly();
+            return result;
+        }
+
+        /**
+         * Schoolbook product with the reduction interleaved: the high
+         * columns are folded into the low ones as soon as they are
+         * summed, so no intermediate exceeds 128 bits.
+         */
+        FieldElement operator*(const FieldElement& other) const {
+            const Limb a0 = this->n[0], a1 = this->n[1], a2 = this->n[2];
+            const Limb a3 = this->n[3], a4 = this->n[4];
+            const Limb b0 = other.n[0], b1 = other.n[1], b2 = other.n[2];
+            const Limb b3 = other.n[3], b4 = other.n[4];
+
+            DoubleLimb d = DoubleLimb(a0) * b3 + DoubleLimb(a1) * b2
+                + DoubleLimb(a2) * b1 + DoubleLimb(a3) * b0;
+            DoubleLimb c = DoubleLimb(a4) * b4;
+            d += DoubleLimb(SHIFTED_REDUCTION) * static_cast<Limb>(c);
+            c >>= 64;
+            const Limb t3 = static_cast<Limb>(d) & LIMB_MASK;
+            d >>= BITS_PER_LIMB;
+
+            d += DoubleLimb(a0) * b4 + DoubleLimb(a1) * b3
+                + DoubleLimb(a2) * b2 + DoubleLimb(a3) * b1
+                + DoubleLimb(a4) * b0;
+            d += DoubleLimb(SHIFTED_REDUCTION << 12) * static_cast<Limb>(c);
+            Limb t4 = static_cast<Limb>(d) & LIMB_MASK;
+            d >>= BITS_PER_LIMB;
+            const Limb tx = t4 >> TOP_LIMB_BITS;
+            t4 &= TOP_LIMB_MASK;
+
+            c = DoubleLimb(a0) * b0;
+            d += DoubleLimb(a1) * b4 + DoubleLimb(a2) * b3
+                + DoubleLimb(a3) * b2 + DoubleLimb(a4) * b1;
+            Limb u0 = static_cast<Limb>(d) & LIMB_MASK;
+            d >>= BITS_PER_LIMB;
+            u0 = (u0 << 4) | tx;
+            c += DoubleLimb(u0) * REDUCTION;
+
+            FieldElement result;
+            result.n[0] = static_cast<Limb>(c) & LIMB_MASK;
+            c >>= BITS_PER_LIMB;
+
+            c += DoubleLimb(a0) * b1 + DoubleLimb(a1) * b0;
+            d += DoubleLimb(a2) * b4 + DoubleLimb(a3) * b3
+                + DoubleLimb(a4) * b2;
+            c += DoubleLimb(static_cast<Limb>(d) & LIMB_MASK)
+                * SHIFTED_REDUCTION;
+            d >>= BITS_PER_LIMB;
+            result.n[1] = static_cast<Limb>(c) & LIMB_MASK;
+            c >>= BITS_PER_LIMB;
+
+            c += DoubleLimb(a0) * b2 + DoubleLimb(a1) * b1
+                + DoubleLimb(a2) * b0;
+            d += DoubleLimb(a3) * b4 + DoubleLimb(a4) * b3;
+            c += DoubleLimb(SHIFTED_REDUCTION) * static_cast<Limb>(d);
+            d >>= 64;
+            result.n[2] = static_cast<Limb>(c) & LIMB_MASK;
+            c >>= BITS_PER_LIMB;
+
+            c += DoubleLimb(SHIFTED_REDUCTION << 12) * static_cast<Limb>(d)
+                + t3;
+            result.n[3] = static_cast<Limb>(c) & LIMB_MASK;
+            c >>= BITS_PER_LIMB;
+            result.n[4] = static_cast<Limb>(c) + t4;
+            return result;
+        }
+
+        /**
+         * Same as multiplying by itself, with the symmetric cross
+         * products computed once and doubled.
+         */
+        FieldElement squared() const {
+            Limb a0 = this->n[0], a1 = this->n[1], a2 = this->n[2];
+            Limb a3 = this->n[3], a4 = this->n[4];
+
+            DoubleLimb d = DoubleLimb(a0 * 2) * a3 + DoubleLimb(a1 * 2) * a2;
+            DoubleLimb c = DoubleLimb(a4) * a4;
+            d += DoubleLimb(SHIFTED_REDUCTION) * static_cast<Limb>(c);
+            c >>= 64;
+            const Limb t3 = static_cast<Limb>(d) & LIMB_MASK;
+            d >>= BITS_PER_LIMB;
+
+            a4 *= 2;
+            d += DoubleLimb(a0) * a4 + DoubleLimb(a1 * 2) * a3
+                + DoubleLimb(a2) * a2;
+            d += DoubleLimb(SHIFTED_REDUCTION << 12) * static_cast<Limb>(c);
+            Limb t4 = static_cast<Limb>(d) & LIMB_MASK;
+            d >>= BITS_PER_LIMB;
+            const Limb tx = t4 >> TOP_LIMB_BITS;
+            t4 &= TOP_LIMB_MASK;
+
+            c = DoubleLimb(a0) * a0;
+            d += DoubleLimb(a1) * a4 + DoubleLimb(a2 * 2) * a3;
+            Limb u0 = static_cast<Limb>(d) & LIMB_MASK;
+            d >>= BITS_PER_LIMB;
+            u0 = (u0 << 4) | tx;
+            c += DoubleLimb(u0) * REDUCTION;
+
+            FieldElement result;
+            result.n[0] = static_cast<Limb>(c) & LIMB_MASK;
+            c >>= BITS_PER_LIMB;
+
+            a0 *= 2;
+            c += DoubleLimb(a0) * a1;
+            d += DoubleLimb(a2) * a4 + DoubleLimb(a3) * a3;
+            c += DoubleLimb(static_cast<Limb>(d) & LIMB_MASK)
+                * SHIFTED_REDUCTION;
+            d >>= BITS_PER_LIMB;
+            result.n[1] = static_cast<Limb>(c) & LIMB_MASK;
+            c >>= BITS_PER_LIMB;
+
+            c += DoubleLimb(a0) * a2 + DoubleLimb(a1) * a1;
+            d += DoubleLimb(a3) * a4;
+            c += DoubleLimb(SHIFTED_REDUCTION) * static_cast<Limb>(d);
+            d >>= 64;
+            result.n[2] = static_cast<Limb>(c) & LIMB_MASK;
+            c >>= BITS_PER_LIMB;
+
+            c += DoubleLimb(SHIFTED_REDUCTION << 12) * static_cast<Limb>(d)
+                + t3;
+            result.n[3] = static_cast<Limb>(c) & LIMB_MASK;
+            c >>= BITS_PER_LIMB;
+            result.n[4] = static_cast<Limb>(c) + t4;
+            return result;
+        }
+
+        /**
+         * Computes a^(p - 2) with a fixed addition chain.
+         */
+        FieldElement inverse() const {
+            const FieldElement& x = *this;
+            const FieldElement x2 = x.squared() * x;
+            const FieldElement x3 = x2.squared() * x;
+            const FieldElement x6 = x3.squared(3) * x3;
+            const FieldElement x9 = x6.squared(3) * x3;
+            const FieldElement x11 = x9.squared(2) * x2;
+            const FieldElement x22 = x11.squared(11) * x11;
+            const FieldElement x44 = x22.squared(22) * x22;
+            const FieldElement x88 = x44.squared(44) * x44;
+            const FieldElement x176 = x88.squared(88) * x88;
+            const FieldElement x220 = x176.squared(44) * x44;
+            const FieldElement x223 = x220.squared(3) * x3;
+            FieldElement result = x223.squared(23) * x22;
+            result = result.squared(5) * x;
+            result = result.squared(3) * x2;
+            return result.squared(2) * x;
+        }
+
+        /**
+         * Computes a^((p + 1) / 4), which is a square root of a whenever a
+         * has one since p = 3 (mod 4). The caller checks the result by
+         * squaring it.
+         */
+        FieldElement squareRoot() const {
+            const FieldElement& x = *this;
+            const FieldElement x2 = x.squared() * x;
+            const FieldElement x3 = x2.squared() * x;
+            const FieldElement x6 = x3.squared(3) * x3;
+            const FieldElement x9 = x6.squared(3) * x3;
+            const FieldElement x11 = x9.squared(2) * x2;
+            const FieldElement x22 = x11.squared(11) * x11;
+            const FieldElement x44 = x22.squared(22) * x22;
+            const FieldElement x88 = x44.squared(44) * x44;
+            const FieldElement x176 = x88.squared(88) * x88;
+            const FieldElement x220 = x176.squared(44) * x44;
+            const FieldElement x223 = x220.squared(3) * x3;
+            FieldElement result = x223.squared(23) * x22;
+            result = result.squared(6) * x2;
+            return result.squared(2);
+        }
+
+        bool operator==(const FieldElement& other) const {
+            return this->normalized().n == other.normalized().n;
+        }
+    };
+}
+
+#endif // SECP256K1_FIELD_ELEMENT_H_INCLUDED
@@ -0,0 +1,172 @@
+#ifndef SECP256K1_JACOBIAN_POINT_H_INCLUDED
+#define SECP256K1_JACOBIAN_POINT_H_INCLUDED
+
+#include <span>
+#include <vector>
+#include "field-element.h"
+
+using namespace std;
+
+namespace EllipticCryptography::Secp256k1 {
+    struct AffinePoint {
+    public:
+        FieldElement x;
+        FieldElement y;
+        bool infinity = true;
+
+    public:
+        AffinePoint() = default;
+
+        AffinePoint(const FieldElement& x, const FieldElement& y)
+        :   x(x),
+            y(y),
+            infinity(false)
+        {}
+
+        AffinePoint negated() const {
+            AffinePoint result = *this;
+            result.y = -this->y;
+            return result;
+        }
+    };
+
+    /**
+     * Point of y^2 = x^3 + 7 in Jacobian coordinates (X : Y : Z), which
+     * stands for the affine point (X / Z^2, Y / Z^3). Additions and
+     * doublings need no field inversions, only the final conversion
+     * back to affine coordinates does.
+     */
+    struct JacobianPoint {
+    public:
+        FieldElement x;
+        FieldElement y;
+        FieldElement z;
+        bool infinity = true;
+
+    public:
+        JacobianPoint() = default;
+
+        JacobianPoint(const AffinePoint& point)
+        :   x(point.x),
+            y(point.y),
+            z(1),
+            infinity(point.infinity)
+        {}
+
+        JacobianPoint doubled() const {
+            if (this->infinity) {
+                return *this;
+            }
+            const FieldElement yy = this->y.squared();
+            const FieldElement s = this->x * yy * 4;
+            const FieldElement m = this->x.squared() * 3;
+            JacobianPoint result;
+            result.infinity = false;
+            result.x = m.squared() - s * 2;
+            result.y = m * (s - result.x) - yy.squared() * 8;
+            result.z = this->y * this->z * 2;
+            return result;
+        }
+
+        /**
+         * Mixed addition of a point with Z = 1.
+         */
+        JacobianPoint operator+(const AffinePoint& other) const {
+            if (other.infinity) {
+                return *this;
+            }
+            if (this->infinity) {
+                return JacobianPoint(other);
+            }
+            const FieldElement zz = this->z.squared();
+            const FieldElement u2 = other.x * zz;
+            const FieldElement s2 = other.y * zz * this->z;
+            const FieldElement h = u2 - this->x;
+            const FieldElement i = s2 - this->y;
+            if (h.isZero()) {
+                return i.isZero() ? this->doubled() : JacobianPoint();
+            }
+            const FieldElement hh = h.squared();
+            const FieldElement hhh = h * hh;
+            const FieldElement t = this->x * hh;
+            JacobianPoint result;
+            result.infinity = false;
+            result.x = i.squared() - hhh - t * 2;
+            result.y = i * (t - result.x) - hhh * this->y;
+            result.z = this->z * h;
+            return result;
+        }
+
+        JacobianPoint operator+(const JacobianPoint& other) const {
+            if (other.infinity) {
+                return *this;
+            }
+            if (this->infinity) {
+                return other;
+            }
+            const FieldElement z1z1 = this->z.squared();
+            const FieldElement z2z2 = other.z.squared();
+            const FieldElement u1 = this->x * z2z2;
+            const FieldElement u2 = other.x * z1z1;
+            const FieldElement s1 = this->y * z2z2 * other.z;
+            const FieldElement s2 = other.y * z1z1 * this->z;
+            const FieldElement h = u2 - u1;
+            const FieldElement i = s2 - s1;
+            if (h.isZero()) {
+                return i.isZero() ? this->doubled() : JacobianPoint();
+            }
+            const FieldElement hh = h.squared();
+            const FieldElement hhh = h * hh;
+            const FieldElement t = u1 * hh;
+            JacobianPoint result;
+            result.infinity = false;
+            result.x = i.squared() - hhh - t * 2;
+            result.y = i * (t - result.x) - hhh * s1;
+            result.z = this->z * other.z * h;
+            return result;
+        }
+
+        AffinePoint toAffine() const {
+            if (this->infinity) {
+                return AffinePoint();
+            }
+            const FieldElement zInverse = this->z.inverse();
+            const FieldElement zInverse2 = zInverse.squared();
+            return AffinePoint(
+                this->x * zInverse2, this->y * zInverse2 * zInverse
+            );
+        }
+
+        /**
+         * Converts many points at the cost of a single field inversion.
+         */
+        static void toAffine(
+            span<const JacobianPoint> points, span<AffinePoint> result
+        ) {
+            vector<FieldElement> prefixProducts(points.size());
+            FieldElement product = 1;
+            for (size_t i = 0; i < points.size(); ++i) {
+                prefixProducts[i] = product;
+                if (!points[i].infinity) {
+                    product = product * points[i].z;
+                }
+            }
+            FieldElement inverse = product.inverse();
+            for (size_t i = points.size(); i-- > 0;) {
+                if (points[i].infinity) {
+                    result[i] = AffinePoint();
+                    continue;
+                }
+                const FieldElement zInverse = inverse * prefixProducts[i];
+                inverse = inverse * points[i].z;
+                const FieldElement zInverse2 = zInverse.squared();
+                result[i] = AffinePoint(
+                    points[i].x * zInverse2,
+                    points[i].y * zInverse2 * zInverse
+                );
+            }
+        }
+    };
+}
+
+#endif // SECP256K1_JACOBIAN_POINT_H_INCLUDED
@@ -0,0 +1,127 @@
+#ifndef SECP256K1_PROJECTIVE_POINT_H_INCLUDED
+#define SECP256K1_PROJECTIVE_POINT_H_INCLUDED
+
+#include <cstdint>
+#include "field-element.h"
+#include "jacobian-point.h"
+
+using namespace std;
+
+namespace EllipticCryptography::Secp256k1 {
+    /**
+     * Point of y^2 = x^3 + 7 in homogeneous projective coordinates
+     * (X : Y : Z), which stands for the affine point (X / Z, Y / Z), with
+     * (0 : 1 : 0) at infinity. Additions and doublings use the complete
+     * formulas of Renes, Costello and Batina for a = 0: they are correct
+     * for every pair of inputs, including equal, opposite and infinite
+     * ones, so they never branch on the points. This is what multiples
+     * of secret scalars are computed with.
+     */
+    struct ProjectivePoint {
+    public:
+        /**
+         * 3 * b for b = 7.
+         */
+        static constexpr uint64_t B3 = 21;
+
+    public:
+        FieldElement x;
+        FieldElement y = 1;
+        FieldElement z;
+
+    public:
+        ProjectivePoint() = default;
+
+        ProjectivePoint(const AffinePoint& point) {
+            if (!point.infinity) {
+                this->x = point.x;
+                this->y = point.y;
+                this->z = 1;
+            }
+        }
+
+        /**
+         * Replaces the point with the other one if the flag is 1 and keeps
+         * it if the flag is 0, without branching on the flag.
+         */
+        void conditionalMove(const ProjectivePoint& other, const uint64_t flag) {
+            this->x.conditionalMove(other.x, flag);
+            this->y.conditionalMove(other.y, flag);
+            this->z.conditionalMove(other.z, flag);
+        }
+
+        ProjectivePoint doubled() const {
+            FieldElement t0 = this->y.squared();
+            FieldElement z3 = t0 * 8;
+            FieldElement t1 = this->y * this->z;
+            FieldElement t2 = this->z.squared() * B3;
+            FieldElement x3 = t2 * z3;
+            FieldElement y3 = t0 + t2;
+            z3 = t1 * z3;
+            t2 = t2 * 3;
+            t0 = t0 - t2;
+            y3 = t0 * y3 + x3;
+            t1 = this->x * this->y;
+            x3 = t0 * t1 * 2;
+            ProjectivePoint result;
+            result.x = x3;
+            result.y = y3;
+            result.z = z3;
+            return result;
+        }
+
+        /**
+         * Mixed addition of an affine point, which must not be at
+         * infinity.
+         */
+        ProjectivePoint operator+(const AffinePoint& other) const {
+            FieldElement t0 = this->x * other.x;
+            FieldElement t1 = this->y * other.y;
+            FieldElement t3 = (other.x + other.y) * (this->x + this->y) - (t0 + t1);
+            const FieldElement t4 = other.y * this->z + this->y;
+            FieldElement y3 = other.x * this->z + this->x;
+            t0 = t0 * 3;
+            const FieldElement t2 = this->z * B3;
+            FieldElement z3 = t1 + t2;
+            t1 = t1 - t2;
+            y3 = y3 * B3;
+            ProjectivePoint result;
+            result.x = t3 * t1 - t4 * y3;
+            result.y = t1 * z3 + y3 * t0;
+            result.z = z3 * t4 + t0 * t3;
+            return result;
+        }
+
+        ProjectivePoint operator+(const ProjectivePoint& other) const {
+            FieldElement t0 = this->x * other.x;
+            FieldElement t1 = this->y * other.y;
+            FieldElement t2 = this->z * other.z;
+            const FieldElement t3 =
+                (this->x + this->y) * (other.x + other.y) - (t0 + t1);
+            const FieldElement t4 =
+                (this->y + this->z) * (other.y + other.z) - (t1 + t2);
+            FieldElement y3 =
+                (this->x + this->z) * (other.x + other.z) - (t0 + t2);
+            t0 = t0 * 3;
+            t2 = t2 * B3;
+            const FieldElement z3 = t1 + t2;
+            t1 = t1 - t2;
+            y3 = y3 * B3;
+            ProjectivePoint result;
+            result.x = t3 * t1 - t4 * y3;
+            result.y = t1 * z3 + y3 * t0;
+            result.z = z3 * t4 + t0 * t3;
+            return result;
+        }
+
+        AffinePoint toAffine() const {
+            if (this->z.isZero()) {
+                return AffinePoint();
+            }
+            const FieldElement zInverse = this->z.inverse();
+            return AffinePoint(this->x * zInverse, this->y * zInverse);
+        }
+    };
+}
+
+#endif // SECP256K1_PROJECTIVE_POINT_H_INCLUDED
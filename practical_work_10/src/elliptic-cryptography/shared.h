@@ -5,7 +5,30 @@
 #include "../definitions.h"
 #include "../big-int.h"
 
+/**
+ * EC_GROUP_cmp dereferences the generators, so groups of custom curves
+ * without one are compared by their field and coefficients.
+ */
 bool areEqual(const EC_GROUP* a, const EC_GROUP* b) {
+    const bool hasGeneratorA = EC_GROUP_get0_generator(a);
+    const bool hasGeneratorB = EC_GROUP_get0_generator(b);
+    if (!hasGeneratorA || !hasGeneratorB) {
+        if (
+            hasGeneratorA != hasGeneratorB
+            || EC_GROUP_get_field_type(a) != EC_GROUP_get_field_type(b)
+        ) {
+            return false;
+        }
+        const BigInt::Context ctx;
+        BigInt pA, aA, bA, pB, aB, bB;
+        if (
+            !EC_GROUP_get_curve(a, pA.output(), aA.output(), bA.output(), ctx.data)
+            || !EC_GROUP_get_curve(b, pB.output(), aB.output(), bB.output(), ctx.data)
+        ) {
+            throw runtime_error(OPERATION_FAILED);
+        }
+        return pA == pB && aA == aB && bA == bB;
+    }
     const int result = EC_GROUP_cmp(a, b, BigInt::Context().data);
     if (result == -1) {
         throw runtime_error(OPERATION_FAILED);
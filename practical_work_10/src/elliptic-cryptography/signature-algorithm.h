@@ -1,75 +1,220 @@
 #ifndef SIGNATURE_ALGORITHM_H_INCLUDED
 #define SIGNATURE_ALGORITHM_H_INCLUDED
 
+#include <memory>
+#include <span>
+#include <stdexcept>
 #include <string>
-#include <sstream>
-#include <iomanip>
-#include <openssl/sha.h>
+#include <string_view>
 #include "../definitions.h"
+#include "../arena.h"
 #include "curve.h"
+#include "curve-context.h"
+#include "hash-function.h"
 #include "key-pair.h"
+#include "nonce-generator.h"
+#include "public-key-cache.h"
 #include "signed-message.h"
 
 namespace EllipticCryptography {
     class SignatureAlgorithm {
     protected:
-        Curve curve;
+        shared_ptr<const CurveContext> context;
+        shared_ptr<PublicKeyCache> publicKeyCache;
+        NonceGeneration nonceGeneration = NonceGeneration::RANDOM;
+        shared_ptr<const HashFunction> hashFunction = make_shared<const EvpHashFunction>();
 
     protected:
-        static Hash computeHash(const OctetString& data) {
-            Hash hash;
-            SHA1(
-                reinterpret_cast<const unsigned char*>(data.data()),
-                data.size(),
-                hash.data()
+        static span<const Byte> toBytes(string_view text) {
+            return span(reinterpret_cast<const Byte*>(text.data()), text.size());
+        }
+
+        /**
+         * Hashes the data into the start of the buffer and returns the size
+         * of the digest.
+         */
+        size_t computeHash(span<const Byte> data, span<Byte> digest) const {
+            const unique_ptr<HashFunction> hashFunction =
+                this->hashFunction->createInstance();
+            hashFunction->update(data);
+            hashFunction->finalize(digest);
+            return hashFunction->getDigestSize();
+        }
+
+        /**
+         * Reads a digest as an integer, truncated to the bit length of the
+         * order of the base point.
+         */
+        BigInt convertHashToBigInt(span<const Byte> digest) const {
+            return BigInt::fromOctetString(
+                digest, this->context->getBasePointOrder().getNumberOfBits()
             );
-            return hash;
         }
 
-        static string convertHashToHex(const Hash& hash) {
-            std::stringstream ss;
-            for (int i = 0; i < hash.size(); ++i) {
-                ss
-                    << setfill('0') << setw(HEX_DIGITS_PER_BYTE)
-                    << hex << static_cast<int>(hash[i]);
-            }
-            return ss.str();
+        BigInt getHashAsBigInt(span<const Byte> data) const {
+            Digest digest;
+            const size_t size = this->computeHash(data, digest);
+            return this->convertHashToBigInt(span(digest).first(size));
         }
 
-        static BigInt getHashAsBigInt(const OctetString& data) {
-            return BigInt(convertHashToHex(computeHash(data)), Radix::HEX);
+        /**
+         * The HMAC of deterministic nonces uses the hash algorithm of the
+         * messages, SHA-256 if the hash function is not an EvpHashFunction.
+         */
+        NonceGenerator createNonceGenerator(
+            span<const Byte> digest, const PrivateKey& privateKey
+        ) const {
+            const EvpHashFunction* evpHashFunction =
+                dynamic_cast<const EvpHashFunction*>(this->hashFunction.get());
+            return NonceGenerator(
+                this->nonceGeneration,
+                privateKey,
+                digest,
+                this->context->getBasePointOrder(),
+                evpHashFunction ? evpHashFunction->getAlgorithm() : HashAlgorithm::SHA256
+            );
+        }
+
+        /**
+         * Computes u1 * G + u2 * Q, from the cached table of Q if the
+         * algorithm has a public key cache that can hold it.
+         */
+        Point mulAdd(
+            const BigInt& u1,
+            const BigInt& u2,
+            const PublicKey& publicKey,
+            const BigInt::Context& ctx
+        ) const {
+            const shared_ptr<const FixedBaseMultiplication> publicKeyMultiples =
+                this->publicKeyCache
+                    ? this->publicKeyCache->get(
+                        publicKey, this->context->getBasePointOrder(), ctx
+                    )
+                    : nullptr;
+            if (!publicKeyMultiples) {
+                return this->context->mulAdd(u1, u2, publicKey, ctx);
+            }
+            return this->context->mulAdd(u1, u2, *publicKeyMultiples, ctx);
         }
 
     public:
-        SignatureAlgorithm(const Curve& curve) : curve(curve) {}
-        SignatureAlgorithm(const SignatureAlgorithm& other) : curve(other.curve) {}
+        SignatureAlgorithm(const Curve& curve) : context(curve.getContext()) {}
+        SignatureAlgorithm(const SignatureAlgorithm& other)
+        :   context(other.context),
+            publicKeyCache(other.publicKeyCache),
+            nonceGeneration(other.nonceGeneration),
+            hashFunction(other.hashFunction)
+        {}
+
+        /**
+         * Makes verification keep tables of multiples of the public keys
+         * in the given cache, which pays off when keys repeat. The cache
+         * may be shared by several algorithms, nullptr turns it off.
+         */
+        void setPublicKeyCache(shared_ptr<PublicKeyCache> publicKeyCache) {
+            this->publicKeyCache = move(publicKeyCache);
+        }
+
+        shared_ptr<PublicKeyCache> getPublicKeyCache() const {
+            return this->publicKeyCache;
+        }
+
+        /**
+         * Chooses how the nonces of new signatures are drawn. With
+         * deterministic nonces signing the same message with the same key
+         * always gives the same signature.
+         */
+        void setNonceGeneration(const NonceGeneration nonceGeneration) {
+            this->nonceGeneration = nonceGeneration;
+        }
+
+        NonceGeneration getNonceGeneration() const {
+            return this->nonceGeneration;
+        }
+
+        /**
+         * Chooses the hash function of messages, SHA-1 by default. Digests
+         * longer than the order of the base point are truncated to its bit
+         * length. Signing and verifying hash with fresh instances made by
+         * createInstance(), so the prototype is never modified.
+         */
+        void setHashFunction(shared_ptr<const HashFunction> hashFunction) {
+            if (!hashFunction) {
+                throw invalid_argument(
+                    "The 'hashFunction' parameter cannot be equal to nullptr"
+                );
+            }
+            this->hashFunction = move(hashFunction);
+        }
+
+        const shared_ptr<const HashFunction>& getHashFunction() const {
+            return this->hashFunction;
+        }
+
+        /**
+         * Signs the message where it lies, without copying it.
+         */
+        virtual Signature sign(span<const Byte> message, const PrivateKey& privateKey) const = 0;
+
+        /**
+         * Signs the text where it lies, without copying it. Named apart
+         * from sign(), whose overloads for text return a SignedMessage.
+         */
+        Signature signView(string_view message, const PrivateKey& privateKey) const {
+            return this->sign(toBytes(message), privateKey);
+        }
+
+        virtual bool verify(
+            span<const Byte> message,
+            const Signature& signature,
+            const PublicKey& publicKey
+        ) const = 0;
+
+        bool verify(
+            string_view message,
+            const Signature& signature,
+            const PublicKey& publicKey
+        ) const {
+            return this->verify(toBytes(message), signature, publicKey);
+        }
+
+        SignedMessage<OctetString> sign(const OctetString& message, const PrivateKey& privateKey) const {
+            return SignedMessage(message, this->sign(span<const Byte>(message), privateKey));
+        }
 
         SignedMessage<string> sign(const string& message, const PrivateKey& privateKey) const {
-            const OctetString data(message.begin(), message.end());
-            const SignedMessage signedMessage = this->sign(data, privateKey);
-            return SignedMessage(message, signedMessage.getSignature());
+            return SignedMessage(message, this->sign(toBytes(message), privateKey));
+        }
+
+        bool verify(
+            const SignedMessage<OctetString>& signedMessage, const PublicKey& publicKey
+        ) const {
+            return this->verify(
+                span<const Byte>(signedMessage.getMessage()),
+                signedMessage.getSignature(),
+                publicKey
+            );
         }
 
         bool verify(
             const SignedMessage<string>& signedMessage, const PublicKey& publicKey
         ) const {
-            OctetString data(signedMessage.getMessage().length());
-            for (int i = 0; i < signedMessage.getMessage().length(); ++i) {
-                data[i] = signedMessage.getMessage()[i];
-            }
-            return verify(SignedMessage(
-                data, signedMessage.getSignature()), publicKey
+            return this->verify(
+                toBytes(signedMessage.getMessage()),
+                signedMessage.getSignature(),
+                publicKey
             );
         }
 
-        virtual SignedMessage<OctetString> sign(const OctetString& message, const PrivateKey& privateKey) const = 0;
-        virtual bool verify(const SignedMessage<OctetString>& signedMessage, const PublicKey& publicKey) const = 0;
         virtual ~SignatureAlgorithm() {}
 
 
         SignatureAlgorithm& operator=(const SignatureAlgorithm& other) {
             if (this != &other) {
-                this->curve = other.curve;
+                this->context = other.context;
+                this->publicKeyCache = other.publicKeyCache;
+                this->nonceGeneration = other.nonceGeneration;
+                this->hashFunction = other.hashFunction;
             }
             return *this;
         }
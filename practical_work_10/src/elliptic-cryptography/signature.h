@@ -15,8 +15,9 @@ namespace EllipticCryptography {
 
     public:
         Signature(const BigInt& r, const BigInt& s) : r(r), s(s) {}
+        Signature(BigInt&& r, BigInt&& s) : r(move(r)), s(move(s)) {}
 
-        BigInt getR() const {
+        const BigInt& getR() const {
             return this->r;
         }
 
@@ -24,7 +25,7 @@ namespace EllipticCryptography {
             return this->r;
         }
 
-        BigInt getS() const {
+        const BigInt& getS() const {
             return this->s;
         }
 
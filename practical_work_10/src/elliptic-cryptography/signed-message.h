@@ -2,6 +2,7 @@
 #ifndef SIGNED_MESSAGE_H_INCLUDED
 #define SIGNED_MESSAGE_H_INCLUDED
 
+#include <utility>
 #include "signature.h"
 
 namespace EllipticCryptography {
@@ -17,7 +18,12 @@ namespace EllipticCryptography {
             signature(signature)
         {}
 
-        T getMessage() const {
+        SignedMessage(T&& message, Signature&& signature)
+        :   message(move(message)),
+            signature(move(signature))
+        {}
+
+        const T& getMessage() const {
             return this->message;
         }
 
@@ -25,7 +31,7 @@ namespace EllipticCryptography {
             return this->message;
         }
 
-        Signature getSignature() const {
+        const Signature& getSignature() const {
             return this->signature;
         }
 
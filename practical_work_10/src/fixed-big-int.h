@@ -0,0 +1,342 @@
+#ifndef FIXED_BIG_INT_H_INCLUDED
+#define FIXED_BIG_INT_H_INCLUDED
+
+#include <array>
+#include <bit>
+#include <compare>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <openssl/bn.h>
+#include "definitions.h"
+#include "big-int.h"
+
+using namespace std;
+
+const size_t BITS_PER_WORD = BN_BITS2;
+
+using DoubleWord = conditional_t<
+    BITS_PER_WORD == 64, unsigned __int128, uint64_t
+>;
+
+/**
+ * Unsigned integer of a fixed width with inline limb storage.
+ * Arithmetic is performed modulo 2^Bits and never touches the heap,
+ * which makes it suitable for scalars and digests of a known length.
+ * Limbs are stored least significant first.
+ */
+template<size_t Bits>
+class FixedBigInt {
+public:
+    static constexpr size_t NUMBER_OF_LIMBS =
+        (Bits + BITS_PER_WORD - 1) / BITS_PER_WORD;
+    static constexpr size_t NUMBER_OF_BYTES =
+        (Bits + BITS_PER_BYTE - 1) / BITS_PER_BYTE;
+
+private:
+    static constexpr Word TOP_LIMB_MASK = Bits % BITS_PER_WORD
+        ? (Word(1) << (Bits % BITS_PER_WORD)) - 1
+        : ~Word(0);
+
+private:
+    array<Word, NUMBER_OF_LIMBS> limbs {};
+
+private:
+    constexpr FixedBigInt& normalize() {
+        this->limbs[NUMBER_OF_LIMBS - 1] &= TOP_LIMB_MASK;
+        return *this;
+    }
+
+    static constexpr Word parseHexDigit(const char digit) {
+        if (digit >= '0' && digit <= '9') {
+            return digit - '0';
+        }
+        if (digit >= 'a' && digit <= 'f') {
+            return digit - 'a' + 10;
+        }
+        if (digit >= 'A' && digit <= 'F') {
+            return digit - 'A' + 10;
+        }
+        throw invalid_argument("Invalid hexadecimal digit");
+    }
+
+public:
+    constexpr FixedBigInt() = default;
+
+    constexpr FixedBigInt(const Word word) {
+        this->limbs[0] = word;
+        this->normalize();
+    }
+
+    constexpr explicit FixedBigInt(const array<Word, NUMBER_OF_LIMBS>& limbs)
+    :   limbs(limbs)
+    {
+        this->normalize();
+    }
+
+    explicit FixedBigInt(const BigInt& value) {
+        if (value.isSmall()) {
+            if (Bits < BITS_PER_WORD && value.small >> (Bits % BITS_PER_WORD)) {
+                throw invalid_argument(
+                    "The value does not fit in " + to_string(Bits) + " bits"
+                );
+            }
+            this->limbs[0] = value.small;
+            return;
+        }
+        if (BN_is_negative(value.data)) {
+            throw invalid_argument("A fixed big integer cannot be negative");
+        }
+        if (BN_num_bits(value.data) > static_cast<int>(Bits)) {
+            throw invalid_argument(
+                "The value does not fit in " + to_string(Bits) + " bits"
+            );
+        }
+        array<Byte, NUMBER_OF_LIMBS * sizeof(Word)> bytes;
+        if (BN_bn2lebinpad(value.data, bytes.data(), bytes.size()) < 0) {
+            throw runtime_error(OPERATION_FAILED);
+        }
+        for (size_t i = 0; i < bytes.size(); ++i) {
+            this->limbs[i / sizeof(Word)] |=
+                Word(bytes[i]) << (i % sizeof(Word) * BITS_PER_BYTE);
+        }
+    }
+
+    static constexpr FixedBigInt fromHex(const string_view hex) {
+        if (hex.size() > (Bits + 3) / 4) {
+            throw invalid_argument(
+                "The value does not fit in " + to_string(Bits) + " bits"
+            );
+        }
+        FixedBigInt result;
+        for (size_t i = 0; i < hex.size(); ++i) {
+            const size_t position = (hex.size() - 1 - i) * 4;
+            result.limbs[position / BITS_PER_WORD] |=
+                parseHexDigit(hex[i]) << (position % BITS_PER_WORD);
+        }
+        return result.normalize();
+    }
+
+    /**
+     * Reads a big-endian byte string, keeping the least significant
+     * Bits bits if it is longer.
+     */
+    static constexpr FixedBigInt fromBytes(span<const Byte> bytes) {
+        FixedBigInt result;
+        const size_t length = min(bytes.size(), NUMBER_OF_LIMBS * sizeof(Word));
+        for (size_t i = 0; i < length; ++i) {
+            result.limbs[i / sizeof(Word)] |=
+                Word(bytes[bytes.size() - 1 - i])
+                << (i % sizeof(Word) * BITS_PER_BYTE);
+        }
+        return result.normalize();
+    }
+
+    /**
+     * Writes the value as a big-endian byte string of NUMBER_OF_BYTES bytes.
+     */
+    constexpr void toBytes(span<Byte, NUMBER_OF_BYTES> bytes) const {
+        for (size_t i = 0; i < NUMBER_OF_BYTES; ++i) {
+            bytes[NUMBER_OF_BYTES - 1 - i] = static_cast<Byte>(
+                this->limbs[i / sizeof(Word)]
+                >> (i % sizeof(Word) * BITS_PER_BYTE)
+            );
+        }
+    }
+
+    BigInt toBigInt() const {
+        array<Byte, NUMBER_OF_LIMBS * sizeof(Word)> bytes;
+        for (size_t i = 0; i < bytes.size(); ++i) {
+            bytes[i] = static_cast<Byte>(
+                this->limbs[i / sizeof(Word)]
+                >> (i % sizeof(Word) * BITS_PER_BYTE)
+            );
+        }
+        BigInt result;
+        if (!BN_lebin2bn(bytes.data(), bytes.size(), result.output())) {
+            throw runtime_error(OPERATION_FAILED);
+        }
+        return result;
+    }
+
+    constexpr const array<Word, NUMBER_OF_LIMBS>& getLimbs() const {
+        return this->limbs;
+    }
+
+    constexpr bool isZero() const {
+        for (const Word limb : this->limbs) {
+            if (limb) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    constexpr bool isBitSet(const size_t n) const {
+        return n < Bits
+            && (this->limbs[n / BITS_PER_WORD] >> (n % BITS_PER_WORD)) & 1;
+    }
+
+    constexpr size_t getNumberOfBits() const {
+        for (size_t i = NUMBER_OF_LIMBS; i-- > 0;) {
+            if (this->limbs[i]) {
+                return i * BITS_PER_WORD + bit_width(this->limbs[i]);
+            }
+        }
+        return 0;
+    }
+
+    /**
+     * Extracts n (at most BITS_PER_WORD) bits starting at the given position.
+     */
+    constexpr Word getBits(const size_t position, const size_t n) const {
+        if (position >= Bits) {
+            return 0;
+        }
+        const size_t index = position / BITS_PER_WORD;
+        const size_t shift = position % BITS_PER_WORD;
+        Word result = this->limbs[index] >> shift;
+        if (shift && index + 1 < NUMBER_OF_LIMBS) {
+            result |= this->limbs[index + 1] << (BITS_PER_WORD - shift);
+        }
+        return n < BITS_PER_WORD ? result & ((Word(1) << n) - 1) : result;
+    }
+
+    /**
+     * Adds in place and returns the carry out of the top bit.
+     */
+    constexpr bool add(const FixedBigInt& other) {
+        Word carry = 0;
+        for (size_t i = 0; i < NUMBER_OF_LIMBS; ++i) {
+            const DoubleWord sum =
+                DoubleWord(this->limbs[i]) + other.limbs[i] + carry;
+            this->limbs[i] = static_cast<Word>(sum);
+            carry = static_cast<Word>(sum >> BITS_PER_WORD);
+        }
+        if constexpr (Bits % BITS_PER_WORD) {
+            carry = this->limbs[NUMBER_OF_LIMBS - 1] >> (Bits % BITS_PER_WORD);
+            this->normalize();
+        }
+        return carry;
+    }
+
+    /**
+     * Subtracts in place and returns the borrow.
+     */
+    constexpr bool subtract(const FixedBigInt& other) {
+        Word borrow = 0;
+        for (size_t i = 0; i < NUMBER_OF_LIMBS; ++i) {
+            const DoubleWord difference =
+                DoubleWord(this->limbs[i]) - other.limbs[i] - borrow;
+            this->limbs[i] = static_cast<Word>(difference);
+            borrow = static_cast<Word>(difference >> BITS_PER_WORD) & 1;
+        }
+        this->normalize();
+        return borrow;
+    }
+
+    /**
+     * Computes the full product without truncation.
+     */
+    template<size_t OtherBits>
+    constexpr FixedBigInt<Bits + OtherBits> multiply(
+        const FixedBigInt<OtherBits>& other
+    ) const {
+        array<Word, FixedBigInt<Bits + OtherBits>::NUMBER_OF_LIMBS> product {};
+        const auto& otherLimbs = other.getLimbs();
+        for (size_t i = 0; i < NUMBER_OF_LIMBS; ++i) {
+            Word carry = 0;
+            for (size_t j = 0; j < otherLimbs.size(); ++j) {
+                if (i + j >= product.size()) {
+                    break;
+                }
+                const DoubleWord t = DoubleWord(this->limbs[i]) * otherLimbs[j]
+                    + product[i + j] + carry;
+                product[i + j] = static_cast<Word>(t);
+                carry = static_cast<Word>(t >> BITS_PER_WORD);
+            }
+            if (i + otherLimbs.size() < product.size()) {
+                product[i + otherLimbs.size()] = carry;
+            }
+        }
+        return FixedBigInt<Bits + OtherBits>(product);
+    }
+
+    /**
+     * Converts to a different width, truncating if it is narrower.
+     */
+    template<size_t OtherBits>
+    constexpr FixedBigInt<OtherBits> resize() const {
+        array<Word, FixedBigInt<OtherBits>::NUMBER_OF_LIMBS> result {};
+        for (size_t i = 0; i < min(result.size(), NUMBER_OF_LIMBS); ++i) {
+            result[i] = this->limbs[i];
+        }
+        return FixedBigInt<OtherBits>(result);
+    }
+
+    constexpr FixedBigInt operator+(const FixedBigInt& other) const {
+        FixedBigInt result(*this);
+        result.add(other);
+        return result;
+    }
+
+    constexpr FixedBigInt operator-(const FixedBigInt& other) const {
+        FixedBigInt result(*this);
+        result.subtract(other);
+        return result;
+    }
+
+    constexpr FixedBigInt operator*(const FixedBigInt& other) const {
+        return this->multiply(other).template resize<Bits>();
+    }
+
+    constexpr FixedBigInt& operator+=(const FixedBigInt& other) {
+        this->add(other);
+        return *this;
+    }
+
+    constexpr FixedBigInt& operator-=(const FixedBigInt& other) {
+        this->subtract(other);
+        return *this;
+    }
+
+    constexpr FixedBigInt& operator*=(const FixedBigInt& other) {
+        return *this = *this * other;
+    }
+
+    constexpr FixedBigInt operator>>(const size_t n) const {
+        FixedBigInt result;
+        for (size_t i = 0; i < NUMBER_OF_LIMBS; ++i) {
+            result.limbs[i] = this->getBits(i * BITS_PER_WORD + n, BITS_PER_WORD);
+        }
+        return result.normalize();
+    }
+
+    constexpr FixedBigInt operator<<(const size_t n) const {
+        FixedBigInt result;
+        const size_t limbShift = n / BITS_PER_WORD;
+        const size_t bitShift = n % BITS_PER_WORD;
+        for (size_t i = NUMBER_OF_LIMBS; i-- > limbShift;) {
+            result.limbs[i] = this->limbs[i - limbShift] << bitShift;
+            if (bitShift && i > limbShift) {
+                result.limbs[i] |=
+                    this->limbs[i - limbShift - 1] >> (BITS_PER_WORD - bitShift);
+            }
+        }
+        return result.normalize();
+    }
+
+    constexpr strong_ordering operator<=>(const FixedBigInt& other) const {
+        for (size_t i = NUMBER_OF_LIMBS; i-- > 0;) {
+            if (this->limbs[i] != other.limbs[i]) {
+                return this->limbs[i] <=> other.limbs[i];
+            }
+        }
+        return strong_ordering::equal;
+    }
+
+    constexpr bool operator==(const FixedBigInt& other) const = default;
+};
+
+#endif // FIXED_BIG_INT_H_INCLUDED
@@ -1,6 +1,8 @@
 #include <iostream>
+#include <algorithm>
 #include "elliptic-cryptography/digital-signature-algorithm.h"
 #include "elliptic-cryptography/schnorr-signature.h"
+#include "fixed-big-int.h"
 
 using namespace std;
 using namespace EllipticCryptography;
@@ -9,8 +11,17 @@ const string SUCCESSFUL_MESSAGE = "Test passed";
 const string FAILURE_MESSAGE = "Test failed";
 
 void test(const string& algorithmName, const SignatureAlgorithm& signatureAlgorithm, const KeyPair& keyPair, const string& message);
+void testBatch(const DigitalSignatureAlgorithm& digitalSignatureAlgorithm, const KeyPair& keyPair);
+void testSchnorrBatch(const SchnorrSignature& schnorrSignature, const KeyPair& keyPair);
+void testEncoding(const Curve& curve, const KeyPair& keyPair);
+void testPublicKeyCache(const Curve& curve, const KeyPair& keyPair, const string& message);
+void testDeterministicNonces(const Curve& curve, const KeyPair& keyPair, const string& message);
+void testFixedBigInt(const KeyPair& keyPair);
 
 int main() {
+    Arena::install();
+    Arena::setEnabled(true);
+
     const BuiltinCurve curve = BuiltinCurve::getById(BuiltinCurve::ID::SECP256K1);
     DigitalSignatureAlgorithm digitalSignatureAlgorithm(curve);
     SchnorrSignature schnorrSignature(curve);
@@ -25,6 +36,28 @@ int main() {
     test("ECDSA", digitalSignatureAlgorithm, keyPair, message);
     cout << endl;
     test("EC-Schnorr", schnorrSignature, keyPair, message);
+    cout << endl;
+
+    testBatch(digitalSignatureAlgorithm, keyPair);
+    cout << endl;
+    testSchnorrBatch(schnorrSignature, keyPair);
+    cout << endl;
+    testEncoding(curve, keyPair);
+    cout << endl;
+    testPublicKeyCache(curve, keyPair, message);
+    cout << endl;
+    testDeterministicNonces(curve, keyPair, message);
+    cout << endl;
+    testFixedBigInt(keyPair);
+    cout << endl;
+
+    cout << "Big number contexts created: "
+        << BigInt::Context::getNumberOfCreatedContexts() << endl;
+    cout << "Allocations served by the arena: "
+        << Arena::getStatistics().pooledAllocations << " of "
+        << Arena::getStatistics().pooledAllocations
+            + Arena::getStatistics().systemAllocations
+        << endl;
 
     return 0;
 }
@@ -72,3 +105,175 @@ void test(const string& algorithmName, const SignatureAlgorithm& signatureAlgori
             ? SUCCESSFUL_MESSAGE : FAILURE_MESSAGE)
         << endl;
 }
+
+void testBatch(const DigitalSignatureAlgorithm& digitalSignatureAlgorithm, const KeyPair& keyPair) {
+    vector<OctetString> messages;
+    for (const string message : {"first", "second", "third", "fourth"}) {
+        messages.push_back(OctetString(message.begin(), message.end()));
+    }
+    const vector<SignedMessage<OctetString>> signedMessages = digitalSignatureAlgorithm.signBatch(messages, keyPair.getPrivateKey());
+
+    cout << "Testing batch signing with the 'ECDSA' algorithm." << endl;
+    cout
+        << "Signature verification for " << signedMessages.size() << " batch-signed messages: "
+        << (all_of(
+            signedMessages.begin(),
+            signedMessages.end(),
+            [&](const SignedMessage<OctetString>& signedMessage) {
+                return digitalSignatureAlgorithm.verify(signedMessage, keyPair.getPublicKey());
+            }
+        )
+            ? SUCCESSFUL_MESSAGE : FAILURE_MESSAGE)
+        << endl;
+
+    vector<SignedMessage<OctetString>> corruptedSignedMessages = signedMessages;
+    corruptedSignedMessages[2].getSignature().getS() = 84239;
+    const vector<PublicKey> publicKeys(signedMessages.size(), keyPair.getPublicKey());
+    const vector<bool> results = digitalSignatureAlgorithm.verifyBatch(corruptedSignedMessages, publicKeys);
+    cout
+        << "Batch verification with the third signature corrupted: "
+        << (results == vector<bool> {true, true, false, true}
+            ? SUCCESSFUL_MESSAGE : FAILURE_MESSAGE)
+        << endl;
+}
+
+void testSchnorrBatch(const SchnorrSignature& schnorrSignature, const KeyPair& keyPair) {
+    vector<CommittedSignedMessage> signedMessages;
+    for (const string message : {"first", "second", "third", "fourth"}) {
+        signedMessages.push_back(schnorrSignature.signWithCommitment(
+            OctetString(message.begin(), message.end()), keyPair.getPrivateKey()
+        ));
+    }
+    const vector<PublicKey> publicKeys(signedMessages.size(), keyPair.getPublicKey());
+
+    cout << "Testing batch verification with the 'EC-Schnorr' algorithm." << endl;
+    cout
+        << "Batch verification of " << signedMessages.size() << " correct signatures: "
+        << (schnorrSignature.verifyBatch(signedMessages, publicKeys)
+            ? SUCCESSFUL_MESSAGE : FAILURE_MESSAGE)
+        << endl;
+
+    signedMessages[2].getSignature().getS() = 84239;
+    cout
+        << "Batch verification with the third signature corrupted: "
+        << (schnorrSignature.verifyBatch(signedMessages, publicKeys)
+            ? SUCCESSFUL_MESSAGE : FAILURE_MESSAGE)
+        << endl;
+    cout
+        << "Search for the corrupted signature: "
+        << (schnorrSignature.findInvalid(signedMessages, publicKeys) == vector<size_t> {2}
+            ? SUCCESSFUL_MESSAGE : FAILURE_MESSAGE)
+        << endl;
+}
+
+void testEncoding(const Curve& curve, const KeyPair& keyPair) {
+    const PublicKey publicKey = keyPair.getPublicKey();
+    vector<Byte> compressed(publicKey.getEncodedSize(PointEncoding::COMPRESSED));
+    vector<Byte> uncompressed(publicKey.getEncodedSize(PointEncoding::UNCOMPRESSED));
+    publicKey.encode(compressed, PointEncoding::COMPRESSED);
+    publicKey.encode(uncompressed, PointEncoding::UNCOMPRESSED);
+
+    cout << "Testing the SEC1 encoding of the public key." << endl;
+    cout
+        << "Decoding the " << compressed.size() << "-byte compressed encoding: "
+        << (curve.decodePoint(compressed) == publicKey
+            ? SUCCESSFUL_MESSAGE : FAILURE_MESSAGE)
+        << endl;
+    cout
+        << "Decoding the " << uncompressed.size() << "-byte uncompressed encoding: "
+        << (curve.decodePoint(uncompressed) == publicKey
+            ? SUCCESSFUL_MESSAGE : FAILURE_MESSAGE)
+        << endl;
+}
+
+void testPublicKeyCache(const Curve& curve, const KeyPair& keyPair, const string& message) {
+    const shared_ptr<PublicKeyCache> publicKeyCache = make_shared<PublicKeyCache>();
+    DigitalSignatureAlgorithm digitalSignatureAlgorithm(curve);
+    SchnorrSignature schnorrSignature(curve);
+    digitalSignatureAlgorithm.setPublicKeyCache(publicKeyCache);
+    schnorrSignature.setPublicKeyCache(publicKeyCache);
+    const SignatureAlgorithm& ecdsa = digitalSignatureAlgorithm;
+    const SignatureAlgorithm& schnorr = schnorrSignature;
+
+    const size_t numberOfSignatures = 4;
+    bool valid = true;
+    for (size_t i = 0; i < numberOfSignatures; ++i) {
+        const string text = message + " " + to_string(i);
+        valid = valid
+            && ecdsa.verify(ecdsa.sign(text, keyPair.getPrivateKey()), keyPair.getPublicKey())
+            && schnorr.verify(schnorr.sign(text, keyPair.getPrivateKey()), keyPair.getPublicKey());
+    }
+    const SignedMessage forged(string("Forged"), ecdsa.sign(message, keyPair.getPrivateKey()).getSignature());
+    const PublicKeyCache::Statistics statistics = publicKeyCache->getStatistics();
+
+    cout << "Testing verification with a public key cache." << endl;
+    cout
+        << "Verifying " << 2 * numberOfSignatures << " signatures: "
+        << (valid ? SUCCESSFUL_MESSAGE : FAILURE_MESSAGE) << endl;
+    cout
+        << "Verifying a forged signature: "
+        << (!ecdsa.verify(forged, keyPair.getPublicKey())
+            ? SUCCESSFUL_MESSAGE : FAILURE_MESSAGE)
+        << endl;
+    cout
+        << "Cache hits: " << statistics.hits << ", misses: " << statistics.misses
+        << ", memory: " << statistics.memoryUsage << " bytes" << endl;
+}
+
+void testDeterministicNonces(const Curve& curve, const KeyPair& keyPair, const string& message) {
+    DigitalSignatureAlgorithm digitalSignatureAlgorithm(curve);
+    digitalSignatureAlgorithm.setNonceGeneration(NonceGeneration::DETERMINISTIC);
+    const SignatureAlgorithm& ecdsa = digitalSignatureAlgorithm;
+    const Signature first = ecdsa.sign(message, keyPair.getPrivateKey()).getSignature();
+    const Signature second = ecdsa.sign(message, keyPair.getPrivateKey()).getSignature();
+    const Signature other = ecdsa.sign(message + "!", keyPair.getPrivateKey()).getSignature();
+
+    cout << "Testing RFC 6979 deterministic nonces." << endl;
+    cout << "Signature: " << first << endl;
+    cout
+        << "Signing the same message twice gives the same signature: "
+        << (first.getR() == second.getR() && first.getS() == second.getS()
+            ? SUCCESSFUL_MESSAGE : FAILURE_MESSAGE)
+        << endl;
+    cout
+        << "Signing another message gives another nonce: "
+        << (!(first.getR() == other.getR()) ? SUCCESSFUL_MESSAGE : FAILURE_MESSAGE)
+        << endl;
+    cout
+        << "Signature verification: "
+        << (ecdsa.verify(SignedMessage(message, first), keyPair.getPublicKey())
+            ? SUCCESSFUL_MESSAGE : FAILURE_MESSAGE)
+        << endl;
+}
+
+void testFixedBigInt(const KeyPair& keyPair) {
+    const BigInt a = keyPair.getPrivateKey();
+    const BigInt b = BigInt("fedcba9876543210fedcba9876543210fedcba9876543210", Radix::HEX);
+    const BigInt modulus = BigInt(1) + BigInt("ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff", Radix::HEX);
+    const FixedBigInt<256> x(a);
+    const FixedBigInt<256> y(b);
+    array<Byte, FixedBigInt<256>::NUMBER_OF_BYTES> bytes;
+    x.toBytes(bytes);
+
+    cout << "Testing the fixed-width big integer." << endl;
+    cout
+        << "Conversion to and from a big integer: "
+        << (x.toBigInt() == a && FixedBigInt<256>::fromBytes(bytes) == x
+            ? SUCCESSFUL_MESSAGE : FAILURE_MESSAGE)
+        << endl;
+    cout
+        << "Addition and subtraction: "
+        << ((x + y).toBigInt() == (a + b) % modulus && (x + y) - y == x
+            ? SUCCESSFUL_MESSAGE : FAILURE_MESSAGE)
+        << endl;
+    cout
+        << "Multiplication: "
+        << (x.multiply(y).toBigInt() == a * b
+            && (x * y).toBigInt() == a * b % modulus
+            ? SUCCESSFUL_MESSAGE : FAILURE_MESSAGE)
+        << endl;
+    cout
+        << "Comparison: "
+        << (x - 1 < x && !(y < y) ? SUCCESSFUL_MESSAGE : FAILURE_MESSAGE)
+        << endl;
+}
@@ -0,0 +1,212 @@
+#ifndef THREAD_POOL_H_INCLUDED
+#define THREAD_POOL_H_INCLUDED
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Fixed set of worker threads with one task deque per worker.
+ *
+ * A worker takes tasks from the front of its own deque and, when that
+ * runs dry, steals from the back of the others, so uneven shards still
+ * keep every core busy. Tasks submitted from a worker go to its own
+ * deque, other threads spread them round-robin.
+ *
+ * A thread waiting in forEachShard runs queued tasks itself instead of
+ * blocking, which also makes nested calls from inside a task safe.
+ */
+class ThreadPool {
+private:
+    struct Queue {
+        mutex queueMutex;
+        deque<function<void()>> tasks;
+    };
+
+    vector<unique_ptr<Queue>> queues;
+    vector<thread> workers;
+    atomic<size_t> nextQueue = 0;
+    atomic<size_t> numberOfQueuedTasks = 0;
+    mutex sleepMutex;
+    condition_variable wakeUp;
+    bool stopping = false;
+
+    inline static thread_local const ThreadPool* currentPool = nullptr;
+    inline static thread_local size_t currentIndex = 0;
+
+public:
+    ThreadPool(const size_t numberOfThreads = getDefaultNumberOfThreads()) {
+        const size_t size = max<size_t>(numberOfThreads, 1);
+        for (size_t i = 0; i < size; ++i) {
+            this->queues.push_back(make_unique<Queue>());
+        }
+        for (size_t i = 0; i < size; ++i) {
+            this->workers.emplace_back([this, i] { this->work(i); });
+        }
+    }
+
+    ThreadPool(const ThreadPool& other) = delete;
+
+    ~ThreadPool() {
+        {
+            const lock_guard<mutex> lock(this->sleepMutex);
+            this->stopping = true;
+        }
+        this->wakeUp.notify_all();
+        for (thread& worker : this->workers) {
+            worker.join();
+        }
+    }
+
+    ThreadPool& operator=(const ThreadPool& other) = delete;
+
+    /**
+     * Pool sized to the hardware, created on first use.
+     */
+    static ThreadPool& getShared() {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    static size_t getDefaultNumberOfThreads() {
+        return max<unsigned>(thread::hardware_concurrency(), 1);
+    }
+
+    size_t getNumberOfThreads() const {
+        return this->workers.size();
+    }
+
+    void submit(function<void()> task) {
+        const size_t index = currentPool == this
+            ? currentIndex
+            : this->nextQueue++ % this->queues.size();
+        {
+            Queue& queue = *this->queues[index];
+            const lock_guard<mutex> lock(queue.queueMutex);
+            queue.tasks.push_back(move(task));
+        }
+        {
+            const lock_guard<mutex> lock(this->sleepMutex);
+            ++this->numberOfQueuedTasks;
+        }
+        this->wakeUp.notify_one();
+    }
+
+    /**
+     * Splits [0, count) into shards of at most shardSize items, calls
+     * function(begin, end) for every shard on the pool and waits for all
+     * of them. The first exception thrown by a shard is rethrown here.
+     */
+    template<class Function>
+    void forEachShard(
+        const size_t count, const size_t shardSize, const Function& function
+    ) {
+        if (count == 0) {
+            return;
+        }
+        const size_t step = max<size_t>(shardSize, 1);
+        const size_t numberOfShards = (count + step - 1) / step;
+        if (numberOfShards == 1) {
+            function(size_t(0), count);
+            return;
+        }
+
+        struct Batch {
+            atomic<size_t> remaining;
+            mutex doneMutex;
+            condition_variable done;
+            exception_ptr error;
+        } batch;
+        batch.remaining = numberOfShards;
+
+        for (size_t begin = 0; begin < count; begin += step) {
+            const size_t end = min(begin + step, count);
+            this->submit([&batch, &function, begin, end] {
+                try {
+                    function(begin, end);
+                } catch (...) {
+                    const lock_guard<mutex> lock(batch.doneMutex);
+                    if (!batch.error) {
+                        batch.error = current_exception();
+                    }
+                }
+                const lock_guard<mutex> lock(batch.doneMutex);
+                if (--batch.remaining == 0) {
+                    batch.done.notify_all();
+                }
+            });
+        }
+
+        while (batch.remaining != 0) {
+            if (this->runOne()) {
+                continue;
+            }
+            unique_lock<mutex> lock(batch.doneMutex);
+            batch.done.wait_for(lock, chrono::milliseconds(1), [&batch] {
+                return batch.remaining == 0;
+            });
+        }
+        // The last shard may still hold the lock while notifying.
+        const lock_guard<mutex> lock(batch.doneMutex);
+        if (batch.error) {
+            rethrow_exception(batch.error);
+        }
+    }
+
+private:
+    bool runOne() {
+        const size_t size = this->queues.size();
+        const size_t own = currentPool == this ? currentIndex : 0;
+        for (size_t i = 0; i < size; ++i) {
+            const size_t index = (own + i) % size;
+            Queue& queue = *this->queues[index];
+            function<void()> task;
+            {
+                const lock_guard<mutex> lock(queue.queueMutex);
+                if (queue.tasks.empty()) {
+                    continue;
+                }
+                if (index == own) {
+                    task = move(queue.tasks.front());
+                    queue.tasks.pop_front();
+                } else {
+                    task = move(queue.tasks.back());
+                    queue.tasks.pop_back();
+                }
+            }
+            --this->numberOfQueuedTasks;
+            task();
+            return true;
+        }
+        return false;
+    }
+
+    void work(const size_t index) {
+        currentPool = this;
+        currentIndex = index;
+        while (true) {
+            if (this->runOne()) {
+                continue;
+            }
+            unique_lock<mutex> lock(this->sleepMutex);
+            this->wakeUp.wait(lock, [this] {
+                return this->stopping || this->numberOfQueuedTasks != 0;
+            });
+            if (this->stopping && this->numberOfQueuedTasks == 0) {
+                return;
+            }
+        }
+    }
+};
+
+#endif // THREAD_POOL_H_INCLUDED
@@ -2,6 +2,7 @@
 #define BIG_INT_H_INCLUDED
 
 #include <ostream>
+#include <vector>
 #include <functional>
 #include <stdexcept>
 #include <bitset>
@@ -20,8 +21,13 @@ enum class Radix {
 
 const string OPERATION_FAILED = "Operation failed";
 
+class MontgomeryContext;
+class FixedBaseExponentiation;
+
 class BigInt {
 private:
+    friend class MontgomeryContext;
+    friend class FixedBaseExponentiation;
     friend ostream& operator<<(ostream& out, const BigInt& bigInt);
 
     using BinaryOperation = function<
@@ -38,6 +44,8 @@ private:
     class Context {
     private:
         friend class BigInt;
+        friend class MontgomeryContext;
+        friend class FixedBaseExponentiation;
 
     private:
         BN_CTX* data;
@@ -104,6 +112,112 @@ private:
         return result;
     }
 
+    /**
+     * Simultaneous exponentiation (Straus): every exponent is split into
+     * fixed windows of the same width, so all the powers share one chain
+     * of squarings and each window costs one multiplication per base.
+     * If a Montgomery context is given, the computation runs entirely in
+     * Montgomery form.
+     */
+    static BigInt multiPowMod(
+        const vector<BigInt>& bases,
+        const vector<BigInt>& exponents,
+        const BigInt& m,
+        BN_MONT_CTX* mont
+    ) {
+        if (bases.size() != exponents.size()) {
+            throw invalid_argument(
+                "The number of bases and exponents must be the same"
+            );
+        }
+
+        Context ctx;
+        const auto multiply = [&](BigInt& result, const BigInt& a, const BigInt& b) {
+            const int succeeded = mont
+                ? BN_mod_mul_montgomery(
+                    result.data, a.data, b.data, mont, ctx.data
+                )
+                : BN_mod_mul(result.data, a.data, b.data, m.data, ctx.data);
+            if (!succeeded) {
+                throw runtime_error(OPERATION_FAILED);
+            }
+        };
+        const auto convert = [&](const BigInt& a) {
+            BigInt result;
+            if (!BN_nnmod(result.data, a.data, m.data, ctx.data)) {
+                throw runtime_error(OPERATION_FAILED);
+            }
+            if (mont && !BN_to_montgomery(
+                result.data, result.data, mont, ctx.data
+            )) {
+                throw runtime_error(OPERATION_FAILED);
+            }
+            return result;
+        };
+
+        int maxNumberOfBits = 0;
+        for (const BigInt& exponent : exponents) {
+            if (BN_is_negative(exponent.data)) {
+                throw invalid_argument("Exponents cannot be negative");
+            }
+            maxNumberOfBits = max(maxNumberOfBits, BN_num_bits(exponent.data));
+        }
+        const int windowWidth = maxNumberOfBits > 768
+            ? 5 : maxNumberOfBits > 240 ? 4 : 3;
+        const size_t tableSize = size_t(1) << windowWidth;
+
+        const BigInt one = convert(1);
+        vector<vector<BigInt>> tables(bases.size());
+        for (size_t i = 0; i < bases.size(); ++i) {
+            tables[i].resize(tableSize);
+            tables[i][0] = one;
+            tables[i][1] = convert(bases[i]);
+            for (size_t d = 2; d < tableSize; ++d) {
+                multiply(tables[i][d], tables[i][d - 1], tables[i][1]);
+            }
+        }
+
+        BigInt result = one;
+        const int numberOfWindows =
+            (maxNumberOfBits + windowWidth - 1) / windowWidth;
+        for (int window = numberOfWindows - 1; window >= 0; --window) {
+            if (window != numberOfWindows - 1) {
+                for (int i = 0; i < windowWidth; ++i) {
+                    multiply(result, result, result);
+                }
+            }
+            for (size_t i = 0; i < exponents.size(); ++i) {
+                size_t digit = 0;
+                for (int bit = windowWidth - 1; bit >= 0; --bit) {
+                    digit = (digit << 1) | BN_is_bit_set(
+                        exponents[i].data, window * windowWidth + bit
+                    );
+                }
+                if (digit) {
+                    multiply(result, result, tables[i][digit]);
+                }
+            }
+        }
+
+        if (mont && !BN_from_montgomery(
+            result.data, result.data, mont, ctx.data
+        )) {
+            throw runtime_error(OPERATION_FAILED);
+        }
+        return result;
+    }
+
+    int compare(const Word& word) const {
+        if (BN_is_negative(this->data)) {
+            return -1;
+        }
+        if (BN_num_bits(this->data) > BN_BITS2) {
+            return 1;
+        }
+        const Word value = BN_get_word(this->data);
+        return value < word ? -1 : value > word;
+    }
+
 public:
     BigInt() {
         this->data = BN_new();
@@ -284,7 +398,7 @@ public:
     }
 
     bool operator<(const Word& word) const {
-        return BN_cmp(this->data, BigInt(word).data) == -1;
+        return this->compare(word) < 0;
     }
 
     bool operator>(const BigInt& other) const {
@@ -292,7 +406,7 @@ public:
     }
 
     bool operator>(const Word& word) const {
-        return BN_cmp(this->data, BigInt(word).data) == 1;
+        return this->compare(word) > 0;
     }
 
     bool operator==(const BigInt& other) const {
@@ -300,7 +414,7 @@ public:
     }
 
     bool operator==(const Word& word) const {
-        return BN_cmp(this->data, BigInt(word).data) == 0;
+        return this->compare(word) == 0;
     }
 
     bool operator!=(const Word& word) const {
@@ -327,6 +441,34 @@ public:
         return perform(BN_mod_exp, a, p, m);
     }
 
+    /**
+     * Computes the product of bases[i]^exponents[i] modulo m in one pass.
+     */
+    static BigInt multiPowMod(
+        const vector<BigInt>& bases,
+        const vector<BigInt>& exponents,
+        const BigInt& m
+    ) {
+        if (!BN_is_odd(m.data)) {
+            return multiPowMod(bases, exponents, m, nullptr);
+        }
+        BN_MONT_CTX* mont = BN_MONT_CTX_new();
+        if (!mont) {
+            throw bad_alloc();
+        }
+        try {
+            if (!BN_MONT_CTX_set(mont, m.data, Context().data)) {
+                throw runtime_error(OPERATION_FAILED);
+            }
+            BigInt result = multiPowMod(bases, exponents, m, mont);
+            BN_MONT_CTX_free(mont);
+            return result;
+        } catch (...) {
+            BN_MONT_CTX_free(mont);
+            throw;
+        }
+    }
+
     static BigInt computeInverseModulo(const BigInt& a, const BigInt& n) {
         Context ctx;
         BigInt result;
@@ -2,12 +2,15 @@
 #define ELGAMAL_H_INCLUDED
 
 #include <array>
+#include <memory>
 #include <vector>
 #include <sstream>
 #include <iomanip>
 #include <openssl/sha.h>
 #include "definitions.h"
 #include "big-int.h"
+#include "montgomery-context.h"
+#include "fixed-base-exponentiation.h"
 
 using Data = vector<Byte>;
 using CipherText = vector<BigInt>;
@@ -18,6 +21,13 @@ const size_t CIPHER_UNIT_PER_PLAINTEXT_BLOCK = 2;
 
 const BigInt P = BigInt::generatePrime(2048);
 const BigInt G = 5;
+const size_t GENERATOR_TABLE_WINDOW_WIDTH = DEFAULT_FIXED_BASE_WINDOW_WIDTH;
+const shared_ptr<const FixedBaseExponentiation> GENERATOR_POWERS =
+    make_shared<const FixedBaseExponentiation>(
+        make_shared<const MontgomeryContext>(P),
+        G,
+        GENERATOR_TABLE_WINDOW_WIDTH
+    );
 
 using PrivateKey = BigInt;
 
@@ -39,18 +49,56 @@ private:
     BigInt p;
     BigInt g;
     BigInt y;
+    shared_ptr<const MontgomeryContext> modulus;
+    /**
+     * Table of powers of g, shared by the keys of the process-wide
+     * parameters and null for the others.
+     */
+    shared_ptr<const FixedBaseExponentiation> generatorPowers;
 
 public:
+    PublicKey(
+        const shared_ptr<const FixedBaseExponentiation>& generatorPowers,
+        const PrivateKey& x
+    )
+    :   p(generatorPowers->getModulus().getModulus()),
+        g(generatorPowers->getBase()),
+        y(generatorPowers->pow(x)),
+        modulus(generatorPowers->getSharedModulus()),
+        generatorPowers(generatorPowers)
+    {}
+
+    /**
+     * A table of powers pays off only over many keys, so a key with its
+     * own parameters computes the powers of g on the fly.
+     */
     PublicKey(const BigInt& p, const BigInt& g, const PrivateKey& x)
     :   p(p),
         g(g),
-        y(BigInt::powMod(g, x, p))
-    {}
+        modulus(make_shared<const MontgomeryContext>(p))
+    {
+        this->y = this->modulus->powMod(g, x);
+    }
 
     BigInt getP() const {
         return this->p;
     }
 
+    const MontgomeryContext& getModulus() const {
+        return *this->modulus;
+    }
+
+    /**
+     * Computes g^exponent mod p, from the table of powers if the key has
+     * one.
+     */
+    BigInt powG(const BigInt& exponent) const {
+        if (this->generatorPowers) {
+            return this->generatorPowers->pow(exponent);
+        }
+        return this->modulus->powMod(this->g, exponent);
+    }
+
     BigInt getG() const {
         return this->g;
     }
@@ -187,15 +235,15 @@ public:
         const PrivateKey privateKey(
             BigInt::generateRandomInInterval(1, P - 1)
         );
-        const PublicKey publicKey(P, G, privateKey);
+        const PublicKey publicKey(GENERATOR_POWERS, privateKey);
         return KeyPair(privateKey, publicKey);
     }
 
     static SignedMessage<Data> sign(
         const Data& message, const KeyPair& keyPair
     ) {
-        const BigInt p = keyPair.getPublicKey().getP();
-        const BigInt g = keyPair.getPublicKey().getG();
+        const PublicKey publicKey = keyPair.getPublicKey();
+        const BigInt p = publicKey.getP();
         const BigInt x = keyPair.getPrivateKey();
 
         const BigInt m = getHashAsBigInt(message);
@@ -205,7 +253,7 @@ public:
             k = BigInt::generateRandomInInterval(1, p - 1);
         }
 
-        const BigInt r = BigInt::powMod(g, k, p);
+        const BigInt r = publicKey.powG(k);
         const BigInt inverseModuloForK = BigInt::computeInverseModulo(
             k, p - 1
         );
@@ -225,19 +273,21 @@ public:
     static bool verify(
         const SignedMessage<Data>& signedMessage, const PublicKey& publicKey
     ) {
+        const MontgomeryContext& modulus = publicKey.getModulus();
         const BigInt p = publicKey.getP();
-        const BigInt g = publicKey.getG();
         const BigInt y = publicKey.getY();
         const BigInt r = signedMessage.getSignature().getR();
         const BigInt s = signedMessage.getSignature().getS();
 
         const BigInt m = getHashAsBigInt(signedMessage.getMessage());
 
+        const vector<BigInt> bases = {y, r};
+        const vector<BigInt> exponents = {r, s};
         return
             r > 0 && r < p && s > 0 && s < p - 1
             &&
-            BigInt::mulMod(BigInt::powMod(y, r, p), BigInt::powMod(r, s, p), p)
-                == BigInt::powMod(g, m, p);
+            modulus.multiPowMod(bases, exponents)
+                == publicKey.powG(m);
     }
 
     static bool verify(
@@ -255,8 +305,8 @@ public:
     static CipherText encrypt(
         const Data& message, const PublicKey& publicKey
     ) {
+        const MontgomeryContext& modulus = publicKey.getModulus();
         const BigInt p = publicKey.getP();
-        const BigInt g = publicKey.getG();
         const BigInt y = publicKey.getY();
 
         CipherText cipherText(
@@ -270,8 +320,8 @@ public:
             }
 
             const BigInt m = message[i];
-            const BigInt a = BigInt::powMod(g, k, p);
-            const BigInt b = BigInt::mulMod(BigInt::powMod(y, k, p), m, p);
+            const BigInt a = publicKey.powG(k);
+            const BigInt b = modulus.mulMod(modulus.powMod(y, k), m);
 
             cipherText[i * CIPHER_UNIT_PER_PLAINTEXT_BLOCK] = a;
             cipherText[i * CIPHER_UNIT_PER_PLAINTEXT_BLOCK + 1] = b;
@@ -287,10 +337,10 @@ public:
     }
 
     static Data decrypt(const CipherText& cipherText, const KeyPair& keyPair) {
+        const MontgomeryContext& modulus = keyPair.getPublicKey().getModulus();
         const BigInt p = keyPair.getPublicKey().getP();
-        const BigInt g = keyPair.getPublicKey().getG();
-        const BigInt y = keyPair.getPublicKey().getY();
         const BigInt x = keyPair.getPrivateKey();
+        const BigInt exponent = p - 1 - x;
 
         Data decryptedMessage(
             cipherText.size() / CIPHER_UNIT_PER_PLAINTEXT_BLOCK
@@ -301,9 +351,7 @@ public:
             const BigInt b = cipherText[
                 i * CIPHER_UNIT_PER_PLAINTEXT_BLOCK + 1
             ];
-            const BigInt m = BigInt::mulMod(
-                b, BigInt::powMod(a, p - 1 - x, p), p
-            );
+            const BigInt m = modulus.mulMod(b, modulus.powMod(a, exponent));
             decryptedMessage[i] = static_cast<Word>(BigInt::mask(m, BITS_PER_BYTE));
         }
 
@@ -0,0 +1,143 @@
+#ifndef FIXED_BASE_EXPONENTIATION_H_INCLUDED
+#define FIXED_BASE_EXPONENTIATION_H_INCLUDED
+
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include <openssl/bn.h>
+#include "definitions.h"
+#include "big-int.h"
+#include "montgomery-context.h"
+
+using namespace std;
+
+const size_t DEFAULT_FIXED_BASE_WINDOW_WIDTH = 4;
+const size_t MAX_FIXED_BASE_WINDOW_WIDTH = 16;
+
+/**
+ * Windowed table of powers of a fixed base modulo a fixed modulus.
+ * For a window width w the table holds base^(d * 2^(w * j)) for every
+ * nonzero w-bit digit d and every window j of the exponent, so a power
+ * costs one multiplication per nonzero window and no squarings.
+ * The table takes (2^w - 1) * ceil(maxExponentLength / w) entries,
+ * a wider window trades memory for fewer multiplications.
+ */
+class FixedBaseExponentiation {
+private:
+    shared_ptr<const MontgomeryContext> modulus;
+    BigInt base;
+    size_t windowWidth;
+    size_t maxExponentLength;
+    size_t rowLength;
+    BigInt one;
+    vector<BigInt> table;
+
+private:
+    void multiply(
+        BigInt& result, const BigInt& a, const BigInt& b, BigInt::Context& ctx
+    ) const {
+        if (!BN_mod_mul_montgomery(
+            result.data, a.data, b.data, this->modulus->data, ctx.data
+        )) {
+            throw runtime_error(OPERATION_FAILED);
+        }
+    }
+
+    /**
+     * Returns the window width, or throws if it is 0 or above
+     * MAX_FIXED_BASE_WINDOW_WIDTH.
+     */
+    static size_t validateWindowWidth(const size_t windowWidth) {
+        if (windowWidth == 0 || windowWidth > MAX_FIXED_BASE_WINDOW_WIDTH) {
+            throw invalid_argument(
+                "The 'windowWidth' parameter cannot be equal to "
+                + to_string(windowWidth)
+            );
+        }
+        return windowWidth;
+    }
+
+public:
+    FixedBaseExponentiation(
+        const shared_ptr<const MontgomeryContext>& modulus,
+        const BigInt& base,
+        const size_t windowWidth = DEFAULT_FIXED_BASE_WINDOW_WIDTH,
+        const size_t maxExponentLength = 0
+    )
+    :   modulus(modulus),
+        base(base),
+        windowWidth(validateWindowWidth(windowWidth)),
+        maxExponentLength(maxExponentLength
+            ? maxExponentLength
+            : BN_num_bits(modulus->getModulus().data)),
+        rowLength((size_t(1) << this->windowWidth) - 1),
+        one(modulus->toMontgomery(1))
+    {
+        const size_t numberOfRows =
+            (this->maxExponentLength + windowWidth - 1) / windowWidth;
+        this->table.resize(numberOfRows * this->rowLength);
+
+        BigInt::Context ctx;
+        BigInt rowBase = modulus->toMontgomery(base);
+        for (size_t row = 0; row < numberOfRows; ++row) {
+            BigInt* entries = &this->table[row * this->rowLength];
+            entries[0] = rowBase;
+            for (size_t d = 1; d < this->rowLength; ++d) {
+                this->multiply(entries[d], entries[d - 1], rowBase, ctx);
+            }
+            this->multiply(
+                rowBase, entries[this->rowLength - 1], rowBase, ctx
+            );
+        }
+    }
+
+    const MontgomeryContext& getModulus() const {
+        return *this->modulus;
+    }
+
+    const shared_ptr<const MontgomeryContext>& getSharedModulus() const {
+        return this->modulus;
+    }
+
+    BigInt getBase() const {
+        return this->base;
+    }
+
+    size_t getWindowWidth() const {
+        return this->windowWidth;
+    }
+
+    BigInt pow(const BigInt& exponent) const {
+        if (BN_is_negative(exponent.data)) {
+            throw invalid_argument("The exponent cannot be negative");
+        }
+        const size_t numberOfBits = BN_num_bits(exponent.data);
+        if (numberOfBits > this->maxExponentLength) {
+            return this->modulus->powMod(this->base, exponent);
+        }
+
+        BigInt::Context ctx;
+        BigInt result = this->one;
+        for (
+            size_t bit = 0, row = 0;
+            bit < numberOfBits;
+            bit += this->windowWidth, ++row
+        ) {
+            size_t digit = 0;
+            for (size_t i = this->windowWidth; i-- > 0;) {
+                digit = (digit << 1) | BN_is_bit_set(exponent.data, bit + i);
+            }
+            if (digit) {
+                this->multiply(
+                    result,
+                    result,
+                    this->table[row * this->rowLength + digit - 1],
+                    ctx
+                );
+            }
+        }
+        return this->modulus->fromMontgomery(result);
+    }
+};
+
+#endif // FIXED_BASE_EXPONENTIATION_H_INCLUDED
@@ -0,0 +1,161 @@
+#ifndef MONTGOMERY_CONTEXT_H_INCLUDED
+#define MONTGOMERY_CONTEXT_H_INCLUDED
+
+#include <stdexcept>
+#include <vector>
+#include <openssl/bn.h>
+#include "definitions.h"
+#include "big-int.h"
+
+using namespace std;
+
+/**
+ * Precomputed Montgomery reduction data for a fixed odd modulus.
+ * Building it once and reusing it avoids the BN_MONT_CTX setup that
+ * BN_mod_exp and BN_mod_mul would otherwise repeat on every call.
+ */
+class MontgomeryContext {
+private:
+    friend class FixedBaseExponentiation;
+
+private:
+    BigInt modulus;
+    BN_MONT_CTX* data = nullptr;
+
+private:
+    BigInt reduce(const BigInt& a, const BigInt::Context& ctx) const {
+        if (!BN_is_negative(a.data) && BN_ucmp(a.data, this->modulus.data) < 0) {
+            return a;
+        }
+        BigInt result;
+        if (!BN_nnmod(result.data, a.data, this->modulus.data, ctx.data)) {
+            throw runtime_error(OPERATION_FAILED);
+        }
+        return result;
+    }
+
+public:
+    MontgomeryContext(const BigInt& modulus)
+    :   modulus(modulus),
+        data(BN_MONT_CTX_new())
+    {
+        if (!this->data) {
+            throw bad_alloc();
+        }
+        if (!BN_is_odd(modulus.data)) {
+            BN_MONT_CTX_free(this->data);
+            throw invalid_argument("The modulus must be odd");
+        }
+        if (!BN_MONT_CTX_set(
+            this->data, modulus.data, BigInt::Context().data
+        )) {
+            BN_MONT_CTX_free(this->data);
+            throw runtime_error(OPERATION_FAILED);
+        }
+    }
+
+    MontgomeryContext(const MontgomeryContext& other)
+    :   modulus(other.modulus),
+        data(BN_MONT_CTX_new())
+    {
+        if (!this->data) {
+            throw bad_alloc();
+        }
+        if (!BN_MONT_CTX_copy(this->data, other.data)) {
+            BN_MONT_CTX_free(this->data);
+            throw runtime_error(OPERATION_FAILED);
+        }
+    }
+
+    ~MontgomeryContext() {
+        BN_MONT_CTX_free(this->data);
+    }
+
+    const BigInt& getModulus() const {
+        return this->modulus;
+    }
+
+    BigInt powMod(const BigInt& a, const BigInt& p) const {
+        BigInt::Context ctx;
+        BigInt result;
+        if (!BN_mod_exp_mont(
+            result.data,
+            a.data,
+            p.data,
+            this->modulus.data,
+            ctx.data,
+            this->data
+        )) {
+            throw runtime_error(OPERATION_FAILED);
+        }
+        return result;
+    }
+
+    BigInt mulMod(const BigInt& a, const BigInt& b) const {
+        BigInt::Context ctx;
+        BigInt result = this->toMontgomery(a);
+        if (!BN_mod_mul_montgomery(
+            result.data,
+            result.data,
+            this->reduce(b, ctx).data,
+            this->data,
+            ctx.data
+        )) {
+            throw runtime_error(OPERATION_FAILED);
+        }
+        return result;
+    }
+
+    BigInt multiPowMod(
+        const vector<BigInt>& bases, const vector<BigInt>& exponents
+    ) const {
+        return BigInt::multiPowMod(bases, exponents, this->modulus, this->data);
+    }
+
+    /**
+     * Multiplies two numbers that are already in Montgomery form,
+     * the result stays in Montgomery form.
+     */
+    BigInt mulMontgomery(const BigInt& a, const BigInt& b) const {
+        BigInt::Context ctx;
+        BigInt result;
+        if (!BN_mod_mul_montgomery(
+            result.data, a.data, b.data, this->data, ctx.data
+        )) {
+            throw runtime_error(OPERATION_FAILED);
+        }
+        return result;
+    }
+
+    BigInt toMontgomery(const BigInt& a) const {
+        BigInt::Context ctx;
+        BigInt result;
+        if (!BN_to_montgomery(
+            result.data, this->reduce(a, ctx).data, this->data, ctx.data
+        )) {
+            throw runtime_error(OPERATION_FAILED);
+        }
+        return result;
+    }
+
+    BigInt fromMontgomery(const BigInt& a) const {
+        BigInt::Context ctx;
+        BigInt result;
+        if (!BN_from_montgomery(result.data, a.data, this->data, ctx.data)) {
+            throw runtime_error(OPERATION_FAILED);
+        }
+        return result;
+    }
+
+    MontgomeryContext& operator=(const MontgomeryContext& other) {
+        if (this != &other) {
+            if (!BN_MONT_CTX_copy(this->data, other.data)) {
+                throw runtime_error(OPERATION_FAILED);
+            }
+            this->modulus = other.modulus;
+        }
+        return *this;
+    }
+};
+
+#endif // MONTGOMERY_CONTEXT_H_INCLUDED
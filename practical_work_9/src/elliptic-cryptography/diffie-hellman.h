@@ -134,9 +134,17 @@ namespace EllipticCryptography {
             const int numberOfParticipants,
             const int step
         ) {
+            vector<Point> results;
+            results.reserve(expressions.size());
             for (auto& expression : expressions) {
                 expression.variables.push_back(currentParticipant.name);
-                expression.result *= currentParticipant.keyPair.getPrivateKey();
+                results.push_back(
+                    expression.result * currentParticipant.keyPair.getPrivateKey()
+                );
+            }
+            Point::normalizeBatch(results);
+            for (size_t i = 0; i < expressions.size(); ++i) {
+                expressions[i].result = results[i];
             }
 
             if (step <= numberOfParticipants) {
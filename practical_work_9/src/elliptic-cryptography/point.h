@@ -3,6 +3,7 @@
 
 #include <ostream>
 #include <stdexcept>
+#include <vector>
 #include <openssl/ec.h>
 #include "../definitions.h"
 #include "../big-int.h"
@@ -77,6 +78,37 @@ namespace EllipticCryptography {
             return coordinates;
         }
 
+        /**
+         * Brings every point to affine form with a single field inversion
+         * shared by the whole batch, so that reading the coordinates of
+         * the points and adding them afterwards is cheap.
+         */
+        static void normalizeBatch(vector<Point>& points) {
+            if (points.empty()) {
+                return;
+            }
+            vector<EC_POINT*> data;
+            data.reserve(points.size());
+            for (const Point& point : points) {
+                if (!areEqual(point.group, points[0].group)) {
+                    throw runtime_error(OPERATION_FAILED);
+                }
+                if (!EC_POINT_is_at_infinity(point.group, point.data)) {
+                    data.push_back(point.data);
+                }
+            }
+            // Deprecated in OpenSSL 3.0, still the only batch inversion.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+            const int result = EC_POINTs_make_affine(
+                points[0].group, data.size(), data.data(), BigInt::Context().data
+            );
+#pragma GCC diagnostic pop
+            if (!result) {
+                throw runtime_error(OPERATION_FAILED);
+            }
+        }
+
         Point doubled() const {
             Point result(this->group);
             if (!EC_POINT_dbl(